@@ -0,0 +1,133 @@
+#ifndef SHMX_BENCH_PERF_COUNTERS_H
+#define SHMX_BENCH_PERF_COUNTERS_H
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace shmx::bench {
+
+    class PerfCounters {
+    public:
+        PerfCounters() = default;
+        ~PerfCounters() {
+            close();
+        }
+        PerfCounters(const PerfCounters&)            = delete;
+        PerfCounters& operator=(const PerfCounters&) = delete;
+
+        bool open(std::uint64_t hitm_raw = 0) {
+            close();
+#if defined(__linux__)
+            bool hw = false;
+            hw |= add("cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+            hw |= add("instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+            hw |= add("llc_misses", PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+            hw |= add("dtlb_misses", PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+            if (hitm_raw) hw |= add("hitm", PERF_TYPE_RAW, hitm_raw);
+            bool sw = false;
+            sw |= add("page_faults", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS);
+            sw |= add("context_switches", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES);
+            sw |= add("cpu_migrations", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_MIGRATIONS);
+            if (hw)
+                source_ = "hardware";
+            else if (sw)
+                source_ = "software";
+            else
+                source_ = "rusage";
+            return true;
+#else
+            (void) hitm_raw;
+            source_ = "none";
+            return false;
+#endif
+        }
+
+        void close() noexcept {
+#if defined(__linux__)
+            for (const auto& c : counters_) ::close(c.fd);
+#endif
+            counters_.clear();
+            source_ = "none";
+        }
+
+        void start() noexcept {
+#if defined(__linux__)
+            for (const auto& c : counters_) {
+                ::ioctl(c.fd, PERF_EVENT_IOC_RESET, 0);
+                ::ioctl(c.fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+            if (counters_.empty()) rusage_begin_ = sample_rusage();
+#endif
+        }
+
+        [[nodiscard]] std::vector<std::pair<std::string, double>> stop() noexcept {
+            std::vector<std::pair<std::string, double>> out;
+#if defined(__linux__)
+            for (const auto& c : counters_) ::ioctl(c.fd, PERF_EVENT_IOC_DISABLE, 0);
+            for (const auto& c : counters_) {
+                std::uint64_t v[3]{};
+                if (::read(c.fd, v, sizeof(v)) != static_cast<ssize_t>(sizeof(v))) continue;
+                const double scale = (v[2] != 0 && v[2] < v[1]) ? static_cast<double>(v[1]) / static_cast<double>(v[2]) : 1.0;
+                out.emplace_back(c.name, static_cast<double>(v[0]) * scale);
+            }
+            if (counters_.empty()) {
+                const auto end = sample_rusage();
+                out.emplace_back("page_faults", static_cast<double>(end.minflt + end.majflt - rusage_begin_.minflt - rusage_begin_.majflt));
+                out.emplace_back("context_switches", static_cast<double>(end.csw - rusage_begin_.csw));
+            }
+#endif
+            return out;
+        }
+
+        [[nodiscard]] const char* source() const noexcept {
+            return source_;
+        }
+
+    private:
+        struct Counter {
+            std::string name;
+            int fd;
+        };
+        struct Rusage {
+            std::uint64_t minflt, majflt, csw;
+        };
+
+#if defined(__linux__)
+        bool add(const char* name, std::uint32_t type, std::uint64_t config) {
+            perf_event_attr attr{};
+            attr.size           = sizeof(attr);
+            attr.type           = type;
+            attr.config         = config;
+            attr.disabled       = 1;
+            attr.exclude_kernel = type == PERF_TYPE_SOFTWARE ? 0 : 1;
+            attr.exclude_hv     = 1;
+            attr.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            const auto fd       = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+            if (fd < 0) return false;
+            counters_.push_back(Counter{name, fd});
+            return true;
+        }
+        static Rusage sample_rusage() noexcept {
+            rusage ru{};
+            ::getrusage(RUSAGE_THREAD, &ru);
+            return Rusage{static_cast<std::uint64_t>(ru.ru_minflt), static_cast<std::uint64_t>(ru.ru_majflt), static_cast<std::uint64_t>(ru.ru_nvcsw + ru.ru_nivcsw)};
+        }
+#endif
+
+        std::vector<Counter> counters_;
+        const char* source_ = "none";
+        Rusage rusage_begin_{};
+    };
+
+} // namespace shmx::bench
+#endif // SHMX_BENCH_PERF_COUNTERS_H
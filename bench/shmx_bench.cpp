@@ -0,0 +1,191 @@
+#include "perf_counters.h"
+#include "shmx_client.h"
+#include "shmx_server.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace shmx;
+
+namespace {
+    struct Options {
+        std::uint32_t iters{20000}, bytes{65536}, streams{4}, slots{8};
+        std::uint64_t hitm_raw{0};
+        std::string name{"shmx_bench"}, json;
+    };
+
+    struct OpResult {
+        std::string name;
+        std::uint64_t count{};
+        double mean_ns{}, p50_ns{}, p90_ns{}, p99_ns{}, max_ns{};
+        std::vector<std::pair<std::string, double>> counters;
+    };
+
+    std::uint64_t now_ns() {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    template <class Fn>
+    OpResult run_op(const char* name, std::uint32_t iters, bench::PerfCounters& pc, Fn&& fn) {
+        std::vector<std::uint64_t> lat(iters);
+        pc.start();
+        for (std::uint32_t i = 0; i < iters; ++i) {
+            const auto t0 = now_ns();
+            fn(i);
+            lat[i] = now_ns() - t0;
+        }
+        auto totals = pc.stop();
+        OpResult r{};
+        r.name  = name;
+        r.count = iters;
+        if (iters == 0) return r;
+        double sum = 0.0;
+        for (const auto v : lat) sum += static_cast<double>(v);
+        std::sort(lat.begin(), lat.end());
+        auto pct  = [&](double p) { return static_cast<double>(lat[static_cast<std::size_t>(p * static_cast<double>(iters - 1))]); };
+        r.mean_ns = sum / iters;
+        r.p50_ns  = pct(0.50);
+        r.p90_ns  = pct(0.90);
+        r.p99_ns  = pct(0.99);
+        r.max_ns  = static_cast<double>(lat.back());
+        for (auto& [k, v] : totals) r.counters.emplace_back(k, v / iters);
+        return r;
+    }
+
+    bool parse(int argc, char** argv, Options& o) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string a = argv[i];
+            if (i + 1 >= argc) return false;
+            const char* v = argv[++i];
+            if (a == "--iters")
+                o.iters = static_cast<std::uint32_t>(std::strtoul(v, nullptr, 10));
+            else if (a == "--bytes")
+                o.bytes = static_cast<std::uint32_t>(std::strtoul(v, nullptr, 10));
+            else if (a == "--streams")
+                o.streams = static_cast<std::uint32_t>(std::strtoul(v, nullptr, 10));
+            else if (a == "--slots")
+                o.slots = static_cast<std::uint32_t>(std::strtoul(v, nullptr, 10));
+            else if (a == "--hitm-raw")
+                o.hitm_raw = std::strtoull(v, nullptr, 0);
+            else if (a == "--name")
+                o.name = v;
+            else if (a == "--json")
+                o.json = v;
+            else
+                return false;
+        }
+        return o.streams > 0 && o.bytes >= o.streams * 8u;
+    }
+
+    void write_json(std::FILE* f, const Options& o, const char* source, const std::vector<OpResult>& ops) {
+        std::fprintf(f, "{\n  \"config\": {\"iters\": %u, \"bytes\": %u, \"streams\": %u, \"slots\": %u},\n", o.iters, o.bytes, o.streams, o.slots);
+        std::fprintf(f, "  \"counter_source\": \"%s\",\n  \"ops\": [\n", source);
+        for (std::size_t i = 0; i < ops.size(); ++i) {
+            const auto& r = ops[i];
+            std::fprintf(f, "    {\"name\": \"%s\", \"count\": %llu, \"latency_ns\": {\"mean\": %.1f, \"p50\": %.1f, \"p90\": %.1f, \"p99\": %.1f, \"max\": %.1f}, \"counters_per_op\": {", r.name.c_str(), static_cast<unsigned long long>(r.count), r.mean_ns, r.p50_ns, r.p90_ns, r.p99_ns, r.max_ns);
+            for (std::size_t k = 0; k < r.counters.size(); ++k) std::fprintf(f, "%s\"%s\": %.3f", k ? ", " : "", r.counters[k].first.c_str(), r.counters[k].second);
+            std::fprintf(f, "}}%s\n", i + 1 < ops.size() ? "," : "");
+        }
+        std::fprintf(f, "  ]\n}\n");
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    Options o;
+    if (!parse(argc, argv, o)) {
+        std::fprintf(stderr, "usage: %s [--iters N] [--bytes B] [--streams S] [--slots K] [--hitm-raw 0xCODE] [--name shm] [--json path]\n", argv[0]);
+        return 2;
+    }
+
+    const std::uint32_t per       = (o.bytes / o.streams) & ~7u;
+    const std::uint32_t frame_cap = o.streams * align_up(per + static_cast<std::uint32_t>(sizeof(TLV) + sizeof(FrameStreamTLV)), ALIGN_TLV);
+
+    std::vector<StaticStream> dir;
+    for (std::uint32_t s = 0; s < o.streams; ++s) dir.push_back(StaticStream{.stream_id = s + 1u, .element_type = DT_F64, .components = 1u, .layout = LAYOUT_SOA_SCALAR, .bytes_per_elem = 8u, .name_utf8 = "s" + std::to_string(s), .extra = {}});
+
+    Server srv;
+    if (!srv.create(Server::Config{.name = o.name, .slots = o.slots, .reader_slots = 4u, .static_bytes_cap = 0u, .frame_bytes_cap = frame_cap, .control_per_reader = 4096u, .reply_per_reader = 4096u, .kv_entries = {}, .queue_cells = 1024u, .queue_cell_bytes = 64u}, dir)) {
+        std::fprintf(stderr, "[bench] server create failed\n");
+        return 1;
+    }
+    Client cli;
+    if (!cli.open(o.name)) {
+        std::fprintf(stderr, "[bench] client open failed\n");
+        return 1;
+    }
+
+    std::vector<double> data(per / 8u);
+    for (std::size_t i = 0; i < data.size(); ++i) data[i] = static_cast<double>(i) * 0.5;
+
+    bench::PerfCounters pc;
+    pc.open(o.hitm_raw);
+
+    std::vector<OpResult> ops;
+    ops.push_back(run_op("publish", o.iters, pc, [&](std::uint32_t i) {
+        auto fm = srv.begin_frame();
+        data[0] = static_cast<double>(i);
+        for (std::uint32_t s = 0; s < o.streams; ++s) (void) Server::append_stream(fm, s + 1u, data.data(), static_cast<std::uint32_t>(data.size()), per);
+        (void) srv.publish_frame(fm, static_cast<double>(i));
+    }));
+
+    FrameView fv{};
+    std::uint64_t misses = 0;
+    ops.push_back(run_op("read", o.iters, pc, [&](std::uint32_t) {
+        if (!cli.latest(fv)) ++misses;
+    }));
+
+    DecodedFrame df{};
+    double sink = 0.0;
+    ops.push_back(run_op("decode", o.iters, pc, [&](std::uint32_t) {
+        if (!Client::decode(fv, df)) return;
+        for (const auto& [sid, item] : df.streams) sink += static_cast<const double*>(item.ptr)[item.elem_count - 1u];
+    }));
+
+    std::uint8_t item[64]{};
+    std::uint32_t item_bytes = 0;
+    std::vector<Server::ControlMsg> msgs;
+    ops.push_back(run_op("control_send_poll", o.iters, pc, [&](std::uint32_t i) {
+        std::memcpy(item, &i, sizeof(i));
+        if (!cli.control_send(TLV_CONTROL_USER, item, sizeof(item)) || !srv.poll_control(msgs, 1u) || msgs.size() != 1u || msgs[0].data.size() != sizeof(item) || std::memcmp(msgs[0].data.data(), &i, sizeof(i)) != 0) ++misses;
+    }));
+    auto q = cli.queue();
+    ops.push_back(run_op("queue_push_pop", o.iters, pc, [&](std::uint32_t i) {
+        std::memcpy(item, &i, sizeof(i));
+        if (!q.try_push(item, sizeof(item)) || !q.try_pop(item, sizeof(item), item_bytes)) ++misses;
+    }));
+
+    srv.rpc_register(1u, [](const Server::RpcRequest& req, std::vector<std::uint8_t>& resp) {
+        resp.assign(req.data.begin(), req.data.end());
+        return RPC_OK;
+    });
+    std::atomic<bool> serving{true};
+    std::thread server_thread([&] {
+        std::vector<Server::ControlMsg> other;
+        while (serving.load(std::memory_order_relaxed)) (void) srv.serve_rpc(other, 64u, 1000000u);
+    });
+    std::uint64_t rpc_failed = 0;
+    ops.push_back(run_op("rpc_call", o.iters, pc, [&](std::uint32_t i) {
+        auto f = cli.call(1u, &i, static_cast<std::uint32_t>(sizeof(i)));
+        if (!f.wait(1000000000ull)) ++rpc_failed;
+    }));
+    serving = false;
+    server_thread.join();
+
+    std::FILE* out = o.json.empty() ? stdout : std::fopen(o.json.c_str(), "wb");
+    if (!out) {
+        std::fprintf(stderr, "[bench] cannot write %s\n", o.json.c_str());
+        return 1;
+    }
+    write_json(out, o, pc.source(), ops);
+    if (out != stdout) std::fclose(out);
+    std::fprintf(stderr, "[bench] counters %s misses %llu rpc_failed %llu sink %.1f\n", pc.source(), static_cast<unsigned long long>(misses), static_cast<unsigned long long>(rpc_failed), sink);
+    cli.close();
+    srv.destroy();
+    return misses == 0 && rpc_failed == 0 ? 0 : 1;
+}
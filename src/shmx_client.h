@@ -1,18 +1,37 @@
 #ifndef SHMX_CLIENT_H
 #define SHMX_CLIENT_H
 #include "shmx_common.h"
+#include "shmx_probes.h"
+#include "shmx_queue.h"
+#include "shmx_simd.h"
+#include "shmx_trace.h"
+#include <algorithm>
 #include <functional>
+#include <iterator>
 #include <limits>
+#include <span>
 #include <string>
 #include <thread>
+#include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <vector>
+#include <version>
+#if defined(__cpp_lib_mdspan)
+#include <array>
+#include <mdspan>
+#endif
 
 namespace shmx {
     struct StaticStreamInfo {
         std::uint32_t id, elem_type, components, layout, bytes_per_elem;
         std::string name;
         std::vector<std::uint8_t> extra;
+        std::uint32_t kind;
+        std::vector<std::uint64_t> shape;
+        std::vector<std::uint64_t> strides;
+        std::vector<StructField> fields;
+        std::uint32_t lod_op, lod_source, lod_factor, lod_bit;
     };
     struct StaticState {
         std::uint64_t session_id, static_hash;
@@ -25,13 +44,327 @@ namespace shmx {
         std::uint32_t bytes{};
         bool session_mismatch{};
         std::uint32_t checksum_mismatch{};
+        std::uint32_t seq{};
     };
     struct DecodedItem {
         const void* ptr;
-        std::uint32_t bytes, elem_count;
+        std::uint32_t bytes, elem_count, encoding;
     };
     struct DecodedFrame {
         std::vector<std::pair<std::uint32_t, DecodedItem>> streams;
+        std::vector<StreamStatsTLV> stats;
+    };
+    struct InterpStream {
+        std::uint32_t stream_id, dtype;
+        void* out;
+        std::size_t capacity;
+        std::uint32_t bytes;
+        bool held;
+    };
+    struct InterpResult {
+        std::uint64_t frame_a, frame_b;
+        double alpha;
+        bool fallback;
+    };
+
+    inline constexpr std::uint32_t INTERP_RETRIES = 4;
+
+    template <class T>
+    class RaggedView {
+    public:
+        class iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type        = std::span<const T>;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = void;
+            using reference         = value_type;
+
+            iterator() = default;
+            iterator(const RaggedView* v, std::uint32_t i) : v_(v), i_(i) {}
+            value_type operator*() const {
+                return (*v_)[i_];
+            }
+            iterator& operator++() {
+                ++i_;
+                return *this;
+            }
+            iterator operator++(int) {
+                auto t = *this;
+                ++i_;
+                return t;
+            }
+            bool operator==(const iterator& o) const noexcept {
+                return i_ == o.i_;
+            }
+
+        private:
+            const RaggedView* v_ = nullptr;
+            std::uint32_t i_     = 0;
+        };
+
+        RaggedView() = default;
+        RaggedView(const std::uint32_t* offsets, const T* values, std::uint32_t rows) : offsets_(offsets), values_(values), rows_(rows) {}
+
+        [[nodiscard]] std::uint32_t size() const noexcept {
+            return rows_;
+        }
+        [[nodiscard]] bool empty() const noexcept {
+            return rows_ == 0u;
+        }
+        [[nodiscard]] std::span<const T> operator[](std::uint32_t row) const noexcept {
+            return {values_ + offsets_[row], values_ + offsets_[row + 1u]};
+        }
+        [[nodiscard]] std::span<const T> values() const noexcept {
+            return {values_, rows_ ? offsets_[rows_] : 0u};
+        }
+        [[nodiscard]] std::span<const std::uint32_t> offsets() const noexcept {
+            return {offsets_, rows_ + 1u};
+        }
+        [[nodiscard]] iterator begin() const noexcept {
+            return {this, 0u};
+        }
+        [[nodiscard]] iterator end() const noexcept {
+            return {this, rows_};
+        }
+
+    private:
+        const std::uint32_t* offsets_ = nullptr;
+        const T* values_              = nullptr;
+        std::uint32_t rows_           = 0;
+    };
+
+    template <class T>
+    class TensorView {
+    public:
+        TensorView() = default;
+        TensorView(const T* data, std::span<const std::uint64_t> extents, std::span<const std::uint64_t> strides) : data_(data), rank_(static_cast<std::uint32_t>(extents.size())) {
+            for (std::uint32_t i = 0; i < rank_; ++i) {
+                extents_[i] = extents[i];
+                strides_[i] = strides[i];
+            }
+        }
+
+        [[nodiscard]] const T* data() const noexcept {
+            return data_;
+        }
+        [[nodiscard]] std::uint32_t rank() const noexcept {
+            return rank_;
+        }
+        [[nodiscard]] std::uint64_t extent(std::uint32_t d) const noexcept {
+            return extents_[d];
+        }
+        [[nodiscard]] std::uint64_t stride(std::uint32_t d) const noexcept {
+            return strides_[d];
+        }
+        [[nodiscard]] std::uint64_t size() const noexcept {
+            std::uint64_t n = rank_ ? 1u : 0u;
+            for (std::uint32_t i = 0; i < rank_; ++i) n *= extents_[i];
+            return n;
+        }
+
+        template <class... I>
+        [[nodiscard]] const T& operator()(I... idx) const noexcept {
+            const std::uint64_t ix[] = {static_cast<std::uint64_t>(idx)...};
+            std::uint64_t off        = 0;
+            for (std::size_t i = 0; i < sizeof...(I); ++i) off += ix[i] * strides_[i];
+            return data_[off];
+        }
+
+        [[nodiscard]] TensorView slice(std::uint32_t dim, std::uint64_t begin, std::uint64_t end) const noexcept {
+            TensorView v = *this;
+            if (dim >= rank_ || begin > end || end > extents_[dim]) return {};
+            v.data_ += begin * strides_[dim];
+            v.extents_[dim] = end - begin;
+            return v;
+        }
+
+        [[nodiscard]] TensorView at(std::uint32_t dim, std::uint64_t index) const noexcept {
+            TensorView v{};
+            if (dim >= rank_ || index >= extents_[dim]) return v;
+            v.data_ = data_ + index * strides_[dim];
+            for (std::uint32_t i = 0; i < rank_; ++i) {
+                if (i == dim) continue;
+                v.extents_[v.rank_] = extents_[i];
+                v.strides_[v.rank_] = strides_[i];
+                ++v.rank_;
+            }
+            return v;
+        }
+
+#if defined(__cpp_lib_mdspan)
+        template <std::size_t R>
+        [[nodiscard]] std::mdspan<const T, std::dextents<std::size_t, R>, std::layout_stride> mdspan() const {
+            using ext_t = std::dextents<std::size_t, R>;
+            std::array<std::size_t, R> e{}, s{};
+            if (R != rank_) return {};
+            for (std::size_t i = 0; i < R; ++i) {
+                e[i] = static_cast<std::size_t>(extents_[i]);
+                s[i] = static_cast<std::size_t>(strides_[i]);
+            }
+            return {data_, std::layout_stride::mapping<ext_t>(ext_t(e), s)};
+        }
+#endif
+
+    private:
+        const T* data_      = nullptr;
+        std::uint32_t rank_ = 0;
+        std::uint64_t extents_[MAX_TENSOR_DIMS]{};
+        std::uint64_t strides_[MAX_TENSOR_DIMS]{};
+    };
+
+    template <class T>
+    class FieldView {
+    public:
+        FieldView() = default;
+        FieldView(const std::uint8_t* base, std::uint32_t stride, std::uint32_t size, std::uint32_t components) : base_(base), stride_(stride), size_(size), components_(components) {}
+
+        [[nodiscard]] std::uint32_t size() const noexcept {
+            return size_;
+        }
+        [[nodiscard]] bool empty() const noexcept {
+            return size_ == 0u;
+        }
+        [[nodiscard]] std::uint32_t components() const noexcept {
+            return components_;
+        }
+        [[nodiscard]] T operator[](std::uint32_t i) const noexcept {
+            return at(i, 0u);
+        }
+        [[nodiscard]] T at(std::uint32_t i, std::uint32_t c) const noexcept {
+            T v;
+            std::memcpy(&v, base_ + static_cast<std::size_t>(i) * stride_ + static_cast<std::size_t>(c) * sizeof(T), sizeof(T));
+            return v;
+        }
+
+    private:
+        const std::uint8_t* base_ = nullptr;
+        std::uint32_t stride_     = 0;
+        std::uint32_t size_       = 0;
+        std::uint32_t components_ = 0;
+    };
+
+    inline std::uint64_t same_frame_id(const DecodedItem& item) noexcept {
+        std::uint64_t fid = 0;
+        if (item.encoding == ENC_SAME && item.bytes >= sizeof(fid)) std::memcpy(&fid, item.ptr, sizeof(fid));
+        return fid;
+    }
+
+    inline bool apply_sparse_update(std::uint8_t* dense, std::uint32_t dense_count, std::uint32_t value_bytes, const DecodedItem& item) noexcept {
+        const auto nnz   = item.elem_count;
+        const auto* body = static_cast<const std::uint8_t*>(item.ptr);
+        if (item.bytes < sizeof(SparseHeader) || nnz > dense_count) return false;
+        SparseHeader sh{};
+        std::memcpy(&sh, body, sizeof(SparseHeader));
+        if (sh.dense_count != dense_count || sh.value_bytes != value_bytes) return false;
+        const auto voff = sparse_values_offset(nnz);
+        if (static_cast<std::uint64_t>(voff) + static_cast<std::uint64_t>(nnz) * value_bytes > item.bytes) return false;
+        const auto* idx = reinterpret_cast<const std::uint32_t*>(body + sizeof(SparseHeader));
+        if (nnz && simd::max_index(idx, nnz) >= dense_count) return false;
+        simd::scatter(dense, body + voff, idx, nnz, value_bytes);
+        return true;
+    }
+
+    class SparseMirror {
+    public:
+        SparseMirror() = default;
+        SparseMirror(std::uint32_t stream_id, std::uint32_t dense_count, std::uint32_t value_bytes) {
+            reset(stream_id, dense_count, value_bytes);
+        }
+
+        void reset(std::uint32_t stream_id, std::uint32_t dense_count, std::uint32_t value_bytes) {
+            stream_id_   = stream_id;
+            dense_count_ = dense_count;
+            value_bytes_ = value_bytes;
+            data_.assign(static_cast<std::size_t>(dense_count) * value_bytes, 0u);
+            valid_    = false;
+            frame_id_ = 0;
+        }
+
+        bool apply(const DecodedFrame& df, std::uint64_t frame_id) {
+            if (frame_id == frame_id_ && valid_) return true;
+            const bool contiguous = valid_ && frame_id == frame_id_ + 1u;
+            bool touched          = false;
+            for (const auto& [sid, item] : df.streams) {
+                if (sid != stream_id_) continue;
+                touched = true;
+                if (item.encoding == ENC_DENSE) {
+                    if (item.elem_count != dense_count_ || item.bytes != data_.size()) {
+                        valid_ = false;
+                        return false;
+                    }
+                    std::memcpy(data_.data(), item.ptr, data_.size());
+                    valid_ = true;
+                } else if (item.encoding == ENC_SPARSE) {
+                    if (!contiguous || !apply_sparse_update(data_.data(), dense_count_, value_bytes_, item)) {
+                        valid_ = false;
+                        return false;
+                    }
+                } else if (item.encoding == ENC_SAME) {
+                    if (!valid_ || frame_id_ < same_frame_id(item)) {
+                        valid_ = false;
+                        return false;
+                    }
+                }
+            }
+            if (!touched && !contiguous) valid_ = false;
+            frame_id_ = frame_id;
+            return valid_;
+        }
+
+        [[nodiscard]] bool valid() const noexcept {
+            return valid_;
+        }
+        [[nodiscard]] std::uint64_t frame_id() const noexcept {
+            return frame_id_;
+        }
+        [[nodiscard]] std::span<const std::uint8_t> bytes() const noexcept {
+            return {data_.data(), data_.size()};
+        }
+        template <class T>
+        [[nodiscard]] std::span<const T> as() const noexcept {
+            return {reinterpret_cast<const T*>(data_.data()), data_.size() / sizeof(T)};
+        }
+
+    private:
+        std::uint32_t stream_id_ = 0, dense_count_ = 0, value_bytes_ = 0;
+        std::vector<std::uint8_t> data_;
+        std::uint64_t frame_id_ = 0;
+        bool valid_             = false;
+    };
+
+    class Client;
+
+    class RpcFuture {
+    public:
+        RpcFuture() = default;
+        ~RpcFuture();
+        RpcFuture(const RpcFuture&)            = delete;
+        RpcFuture& operator=(const RpcFuture&) = delete;
+        RpcFuture(RpcFuture&& o) noexcept : cli_(std::exchange(o.cli_, nullptr)), id_(o.id_), status_(o.status_), data_(std::move(o.data_)) {}
+        RpcFuture& operator=(RpcFuture&& o) noexcept;
+
+        [[nodiscard]] bool pending() const noexcept {
+            return cli_ != nullptr;
+        }
+        [[nodiscard]] bool ready();
+        bool wait(std::uint64_t timeout_ns);
+        [[nodiscard]] std::uint32_t status() const noexcept {
+            return status_;
+        }
+        [[nodiscard]] const std::vector<std::uint8_t>& data() const noexcept {
+            return data_;
+        }
+
+    private:
+        friend class Client;
+        explicit RpcFuture(std::uint32_t status) : status_(status) {}
+        RpcFuture(Client* cli, std::uint64_t id) : cli_(cli), id_(id) {}
+
+        Client* cli_          = nullptr;
+        std::uint64_t id_     = 0;
+        std::uint32_t status_ = RPC_PENDING;
+        std::vector<std::uint8_t> data_;
     };
 
     class Client {
@@ -76,6 +409,9 @@ namespace shmx {
             GH_                = nullptr;
             reader_slot_index_ = UINT32_MAX;
             reader_id_         = 0;
+            next_frame_id_     = 0;
+            for (auto& [id, r] : rpc_pending_)
+                if (r.status == RPC_PENDING) r.status = RPC_SEND_FAILED;
         }
 
         [[nodiscard]] GlobalHeader* header() noexcept {
@@ -91,9 +427,18 @@ namespace shmx {
             out.static_gen    = g1;
             out.static_hash   = GH->static_hash;
             out.payload_bytes = GH->static_bytes_used;
-            out.dir.clear();
-            const std::uint8_t* cur = map_.data() + GH->static_offset;
-            const std::uint8_t* end = cur + GH->static_bytes_used;
+            parse_static_dir(map_.data() + GH->static_offset, GH->static_bytes_used, out.dir);
+            const auto g2 = GH->static_gen.load(std::memory_order_acquire);
+            return g1 == g2;
+        }
+
+        static void parse_static_dir(const std::uint8_t* data, std::uint32_t bytes, std::vector<StaticStreamInfo>& dir) {
+            dir.clear();
+            std::vector<StaticShapeDesc> shapes;
+            std::vector<std::pair<std::uint32_t, std::vector<StructField>>> fields;
+            std::vector<StaticLodDesc> lods;
+            const std::uint8_t* cur = data;
+            const std::uint8_t* end = data + bytes;
             while (cur + sizeof(TLV) <= end) {
                 TLV tlv{};
                 std::memcpy(&tlv, cur, sizeof(TLV));
@@ -105,17 +450,101 @@ namespace shmx {
                     std::memcpy(&ss, cur + sizeof(TLV), sizeof(StaticStreamDesc));
                     const auto* pName = reinterpret_cast<const char*>(cur + sizeof(TLV) + sizeof(StaticStreamDesc));
                     if (sizeof(StaticStreamDesc) + ss.name_len + ss.extra_len > tlv.length) break;
-                    StaticStreamInfo si{ss.stream_id, ss.element_type, ss.components, ss.layout, ss.bytes_per_elem, std::string(pName, pName + ss.name_len), {}};
+                    StaticStreamInfo si{ss.stream_id, ss.element_type, ss.components, ss.layout, ss.bytes_per_elem, std::string(pName, pName + ss.name_len), {}, ss.kind, {}, {}, {}, LOD_NONE, 0u, 0u, 0u};
                     if (ss.extra_len) {
                         const auto* pExtra = reinterpret_cast<const std::uint8_t*>(pName + ss.name_len);
                         si.extra.assign(pExtra, pExtra + ss.extra_len);
                     }
-                    out.dir.emplace_back(std::move(si));
+                    dir.emplace_back(std::move(si));
+                } else if (tlv.type == TLV_STATIC_SHAPE && tlv.length >= sizeof(StaticShapeDesc)) {
+                    StaticShapeDesc sd{};
+                    std::memcpy(&sd, cur + sizeof(TLV), sizeof(StaticShapeDesc));
+                    if (sd.ndim != 0u && sd.ndim <= MAX_TENSOR_DIMS) shapes.push_back(sd);
+                } else if (tlv.type == TLV_STATIC_FIELDS) {
+                    auto& [sid, list] = fields.emplace_back();
+                    if (!decode_struct_fields(cur + sizeof(TLV), tlv.length, sid, list)) fields.pop_back();
+                } else if (tlv.type == TLV_STATIC_LOD && tlv.length >= sizeof(StaticLodDesc)) {
+                    std::memcpy(&lods.emplace_back(), cur + sizeof(TLV), sizeof(StaticLodDesc));
                 }
                 cur += align_up(static_cast<std::uint32_t>(sizeof(TLV)) + tlv.length, 16);
             }
-            const auto g2 = GH->static_gen.load(std::memory_order_acquire);
-            return g1 == g2;
+            for (const auto& ld : lods) {
+                for (auto& si : dir) {
+                    if (si.id != ld.stream_id) continue;
+                    si.lod_op     = ld.op;
+                    si.lod_source = ld.source_id;
+                    si.lod_factor = ld.factor;
+                    si.lod_bit    = ld.bit;
+                }
+            }
+            for (const auto& sd : shapes) {
+                for (auto& si : dir) {
+                    if (si.id != sd.stream_id) continue;
+                    si.shape.assign(sd.extents, sd.extents + sd.ndim);
+                    si.strides.assign(sd.strides, sd.strides + sd.ndim);
+                }
+            }
+            for (const auto& [sid, list] : fields) {
+                for (auto& si : dir)
+                    if (si.id == sid) si.fields = list;
+            }
+        }
+
+        [[nodiscard]] bool copy_static(std::vector<std::uint8_t>& out, std::uint32_t& gen) {
+            const auto* GH = header();
+            if (!GH || !basic_sanity(*GH)) return false;
+            gen = GH->static_gen.load(std::memory_order_acquire);
+            out.assign(map_.data() + GH->static_offset, map_.data() + GH->static_offset + GH->static_bytes_used);
+            return GH->static_gen.load(std::memory_order_acquire) == gen;
+        }
+
+        [[nodiscard]] TaskQueue queue() {
+            const auto* GH = header();
+            if (!GH || GH->queue_cells == 0u) return {};
+            return TaskQueue(map_.data() + GH->queue_offset, GH->queue_cells, GH->queue_cell_bytes);
+        }
+
+        template <class T> [[nodiscard]] T* sync_object(std::uint32_t index) {
+            static_assert(std::is_standard_layout_v<T> && sizeof(T) <= SYNC_CELL_BYTES, "sync objects must be standard layout and fit one cell");
+            const auto* GH = header();
+            if (!GH || index >= GH->sync_cells) return nullptr;
+            return reinterpret_cast<T*>(map_.data() + GH->sync_offset + static_cast<std::size_t>(index) * SYNC_CELL_BYTES);
+        }
+
+        [[nodiscard]] bool kv_get(std::string_view key, void* dst, std::uint32_t cap, std::uint32_t& bytes, std::uint32_t* version = nullptr) {
+            const auto* GH = header();
+            bytes          = 0;
+            if (!GH || key.empty() || key.size() > KV_KEY_MAX) return false;
+            const auto h = kv_hash(key);
+            for (std::uint32_t c = 0; c < KV_CLASSES; ++c) {
+                const auto n     = GH->kv_entries[c];
+                const auto* base = map_.data() + kv_class_offset(*GH, c);
+                for (std::uint32_t k = 0, i = static_cast<std::uint32_t>(h) & (n - 1u); k < n; ++k, i = (i + 1u) & (n - 1u)) {
+                    const auto r = kv_read(reinterpret_cast<const KvEntry*>(base + static_cast<std::size_t>(i) * kv_entry_stride(c)), KV_CLASS_BYTES[c], key, h, dst, cap, bytes, version);
+                    if (r == KvRead::Hit) return true;
+                    if (r == KvRead::Fail) return false;
+                    if (r == KvRead::Empty) break;
+                }
+            }
+            return false;
+        }
+
+        [[nodiscard]] bool kv_get(std::string_view key, std::vector<std::uint8_t>& out, std::uint32_t* version = nullptr) {
+            std::uint32_t bytes = 0;
+            out.resize(KV_CLASS_BYTES[KV_CLASSES - 1u]);
+            const bool ok = kv_get(key, out.data(), static_cast<std::uint32_t>(out.size()), bytes, version);
+            out.resize(ok ? bytes : 0u);
+            return ok;
+        }
+
+        template <class T>
+        [[nodiscard]] bool kv_get(std::string_view key, T& out, std::uint32_t* version = nullptr) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            std::uint32_t bytes = 0;
+            T tmp;
+            if (!kv_get(key, &tmp, static_cast<std::uint32_t>(sizeof(T)), bytes, version) || bytes != sizeof(T)) return false;
+            out = tmp;
+            return true;
         }
 
         [[nodiscard]] bool latest(FrameView& out) {
@@ -123,24 +552,43 @@ namespace shmx {
             if (!GH || !basic_sanity(*GH)) return false;
             if (GH->slots == 0) return false;
             const auto w = GH->write_index.load(std::memory_order_acquire);
-            if (w == 0u) return false;
+            if (w == 0u) {
+                SHMX_PROBE2(read_fail, READ_FAIL_NO_FRAME, 0u);
+                return false;
+            }
             const auto slot       = (w - 1u) % GH->slots;
             const auto* base_slot = map_.data() + GH->slots_offset + slot * GH->slot_stride;
             const auto* FH        = reinterpret_cast<const FrameHeader*>(base_slot);
             const auto* payload   = base_slot + align_up(static_cast<std::uint32_t>(sizeof(FrameHeader)), 64);
             const auto bytes      = FH->payload_bytes;
-            if (bytes == 0 || bytes > GH->frame_bytes_cap) return false;
+            if (bytes == 0 || bytes > GH->frame_bytes_cap) {
+                SHMX_PROBE2(read_fail, READ_FAIL_BAD_SIZE, slot);
+                return false;
+            }
             const bool mismatch = FH->session_id_copy != GH->session_id;
-            if (mismatch) return false;
+            if (mismatch) {
+                SHMX_PROBE2(read_fail, READ_FAIL_SESSION, slot);
+                return false;
+            }
+            const auto fid = FH->frame_id.load(std::memory_order_acquire);
+            TraceScope ts(STAGE_VALIDATE, fid, 0u, bytes);
             const auto calc        = checksum32(payload, bytes);
             const std::uint32_t cm = FH->checksum;
-            out                    = FrameView{FH, payload, bytes, false, static_cast<std::uint32_t>(calc != cm)};
-            heartbeat_seen(FH->frame_id.load(std::memory_order_acquire));
-            return out.checksum_mismatch == 0u;
+            out                    = FrameView{FH, payload, bytes, false, static_cast<std::uint32_t>(calc != cm), w};
+            heartbeat_seen(fid);
+            if (out.checksum_mismatch != 0u) {
+                SHMX_PROBE3(checksum_mismatch, fid, bytes, slot);
+                SHMX_PROBE2(read_fail, READ_FAIL_CHECKSUM, slot);
+                return false;
+            }
+            SHMX_PROBE3(read_ok, fid, bytes, slot);
+            return true;
         }
 
         [[nodiscard]] static bool decode(const FrameView& fv, DecodedFrame& df) {
+            TraceScope ts(STAGE_DECODE, fv.fh ? fv.fh->frame_id.load(std::memory_order_acquire) : 0u, 0u, fv.bytes);
             df.streams.clear();
+            df.stats.clear();
             const auto* cur = fv.payload;
             const auto* end = fv.payload + fv.bytes;
             while (cur + sizeof(TLV) <= end) {
@@ -148,65 +596,249 @@ namespace shmx {
                 std::memcpy(&tlv, cur, sizeof(TLV));
                 const auto tlv_end = cur + sizeof(TLV) + tlv.length;
                 if (tlv_end > end) break;
-                if (tlv.type == TLV_FRAME_STREAM) {
+                if (tlv.type == TLV_FRAME_STREAM || tlv.type == TLV_FRAME_SPARSE || tlv.type == TLV_FRAME_SAME) {
                     if (tlv.length < sizeof(FrameStreamTLV)) break;
                     FrameStreamTLV fs{};
                     std::memcpy(&fs, cur + sizeof(TLV), sizeof(FrameStreamTLV));
                     const auto* body = cur + sizeof(TLV) + sizeof(FrameStreamTLV);
                     const auto have  = static_cast<std::size_t>(end - body);
                     if (have < fs.bytes_payload) break;
-                    df.streams.emplace_back(fs.stream_id, DecodedItem{body, fs.bytes_payload, fs.elem_count});
+                    df.streams.emplace_back(fs.stream_id, DecodedItem{body, fs.bytes_payload, fs.elem_count, frame_encoding(tlv.type)});
+                } else if (tlv.type == TLV_FRAME_STATS && tlv.length >= sizeof(StreamStatsTLV)) {
+                    std::memcpy(&df.stats.emplace_back(), cur + sizeof(TLV), sizeof(StreamStatsTLV));
                 }
                 cur += align_up(static_cast<std::uint32_t>(sizeof(TLV)) + tlv.length, 16);
             }
             return true;
         }
 
+        [[nodiscard]] static bool stream_stats(const FrameView& fv, std::uint32_t stream_id, StreamStatsTLV& out) noexcept {
+            return fv.payload && find_stream_stats(fv.payload, fv.bytes, stream_id, out);
+        }
+
+        [[nodiscard]] static const StructField* find_field(const StaticStreamInfo& info, std::string_view name) noexcept {
+            for (const auto& f : info.fields)
+                if (f.name == name) return &f;
+            return nullptr;
+        }
+
+        template <class T>
+        [[nodiscard]] static bool field(const StaticStreamInfo& info, const DecodedItem& item, std::string_view name, FieldView<T>& out) {
+            out = {};
+            const StructField* f = struct_field(info, item, name);
+            if (!f || dtype_size(f->dtype) != sizeof(T)) return false;
+            out = FieldView<T>(static_cast<const std::uint8_t*>(item.ptr) + f->offset, info.bytes_per_elem, item.bytes / info.bytes_per_elem, f->count);
+            return true;
+        }
+
+        [[nodiscard]] static bool extract_field(const StaticStreamInfo& info, const DecodedItem& item, std::string_view name, std::uint32_t component, void* dst, std::size_t dst_bytes) {
+            const StructField* f = struct_field(info, item, name);
+            if (!f || component >= f->count) return false;
+            const auto vb = dtype_size(f->dtype);
+            const auto n  = item.bytes / info.bytes_per_elem;
+            if (static_cast<std::size_t>(n) * vb > dst_bytes) return false;
+            simd::gather_strided(dst, static_cast<const std::uint8_t*>(item.ptr) + f->offset + component * vb, info.bytes_per_elem, n, vb);
+            return true;
+        }
+
+        template <class T>
+        [[nodiscard]] static bool extract_field(const StaticStreamInfo& info, const DecodedItem& item, std::string_view name, std::uint32_t component, std::vector<T>& out) {
+            const StructField* f = struct_field(info, item, name);
+            if (!f || dtype_size(f->dtype) != sizeof(T)) return false;
+            out.resize(item.bytes / info.bytes_per_elem);
+            return extract_field(info, item, name, component, out.data(), out.size() * sizeof(T));
+        }
+
+        template <class T>
+        [[nodiscard]] static bool tensor(const StaticStreamInfo& info, const DecodedItem& item, TensorView<T>& out) {
+            out = {};
+            if (!item.ptr || item.encoding != ENC_DENSE || info.shape.empty() || info.shape.size() != info.strides.size()) return false;
+            std::uint64_t last = 0;
+            for (std::size_t i = 0; i < info.shape.size(); ++i) {
+                if (info.shape[i] == 0u) {
+                    out = TensorView<T>(static_cast<const T*>(item.ptr), info.shape, info.strides);
+                    return true;
+                }
+                last += (info.shape[i] - 1u) * info.strides[i];
+            }
+            if ((last + 1u) > item.bytes / sizeof(T)) return false;
+            out = TensorView<T>(static_cast<const T*>(item.ptr), info.shape, info.strides);
+            return true;
+        }
+
+        template <class T>
+        [[nodiscard]] static bool ragged(const DecodedItem& item, RaggedView<T>& out) {
+            out              = {};
+            const auto rows  = item.elem_count;
+            const auto* body = static_cast<const std::uint8_t*>(item.ptr);
+            if (!body || rows >= item.bytes / sizeof(std::uint32_t)) return false;
+            const auto voff = ragged_values_offset(rows);
+            if (item.bytes < voff) return false;
+            const auto* offs = reinterpret_cast<const std::uint32_t*>(body);
+            if (offs[0] != 0u) return false;
+            for (std::uint32_t i = 0; i < rows; ++i) {
+                if (offs[i + 1u] < offs[i]) return false;
+            }
+            if (static_cast<std::uint64_t>(offs[rows]) * sizeof(T) > item.bytes - voff) return false;
+            out = RaggedView<T>(offs, reinterpret_cast<const T*>(body + voff), rows);
+            return true;
+        }
+
         [[nodiscard]] bool control_send(std::uint32_t tlv_type, const void* data, std::uint32_t bytes) {
+            if (!control_push(tlv_type, data, bytes)) return false;
+            doorbell_ring(header()->control_bell);
+            return true;
+        }
+
+        [[nodiscard]] bool wait_frame(std::uint64_t after_frame_id, std::uint64_t timeout_ns) {
             auto* GH = header();
-            if (!GH || GH->control_per_reader == 0) return false;
-            if (reader_slot_index_ == UINT32_MAX) {
-                if (!attach_slot()) return false;
+            if (!GH || !basic_sanity(*GH) || GH->slots == 0u) return false;
+            const auto deadline = deadline_after(timeout_ns);
+            for (;;) {
+                auto& bell      = wake_bell(*GH);
+                const auto seen = bell.seq.load(std::memory_order_acquire);
+                if (released_frame_id(*GH) > after_frame_id) return true;
+                if (!doorbell_wait_until(bell, seen, deadline)) return released_frame_id(*GH) > after_frame_id;
             }
-            auto* RS = reinterpret_cast<ReaderSlot*>(map_.data() + GH->readers_offset + reader_slot_index_ * GH->reader_slot_stride);
-            RS->heartbeat.store(now_ticks(), std::memory_order_release);
-            auto* const CH  = map_.data() + GH->control_offset + reader_slot_index_ * GH->control_stride;
-            const auto cap  = GH->control_per_reader;
-            auto* const r64 = reinterpret_cast<std::atomic<std::uint64_t>*>(CH);
-            auto* const w64 = r64 + 1;
-            const auto need = align_up(static_cast<std::uint32_t>(sizeof(TLV)) + bytes, 16);
-            const auto rv0  = r64->load(std::memory_order_acquire);
-            const auto wv0  = w64->load(std::memory_order_acquire);
-            if (((wv0 + need) - rv0) > (cap - 16u)) return false;
-            auto wv           = wv0;
-            auto off          = 16u + static_cast<std::uint32_t>(wv % (cap - 16u));
-            auto space_to_end = cap - off;
-            if (need > space_to_end) {
-                const auto span_to_end = (cap - 16u) - static_cast<std::uint32_t>(wv % (cap - 16u));
-                if (((wv + span_to_end) - rv0) > (cap - 16u)) return false;
-                if (space_to_end >= sizeof(TLV)) {
-                    TLV pad{};
-                    pad.type   = 0u;
-                    pad.length = static_cast<std::uint32_t>(space_to_end - sizeof(TLV));
-                    std::memcpy(CH + off, &pad, sizeof(TLV));
-                    std::atomic_thread_fence(std::memory_order_release);
+        }
+
+        [[nodiscard]] bool next(FrameView& out, std::uint64_t timeout_ns) {
+            auto* GH = header();
+            if (!GH || !basic_sanity(*GH) || GH->slots == 0u) return false;
+            const auto deadline = deadline_after(timeout_ns);
+            for (;;) {
+                auto& bell      = wake_bell(*GH);
+                const auto seen = bell.seq.load(std::memory_order_acquire);
+                if (released_frame_id(*GH) > next_frame_id_ && latest(out)) {
+                    const auto fid = out.fh->frame_id.load(std::memory_order_acquire);
+                    if (fid > next_frame_id_) {
+                        next_frame_id_ = fid;
+                        return true;
+                    }
                 }
-                wv += span_to_end;
-                w64->store(wv, std::memory_order_release);
-                off = 16u;
-                if (((wv + need) - rv0) > (cap - 16u)) return false;
-            }
-            TLV tlv{};
-            tlv.type   = tlv_type;
-            tlv.length = bytes;
-            std::memcpy(CH + off, &tlv, sizeof(TLV));
-            std::memcpy(CH + off + sizeof(TLV), data, bytes);
-            std::atomic_thread_fence(std::memory_order_release);
-            wv += need;
-            w64->store(wv, std::memory_order_release);
+                if (!doorbell_wait_until(bell, seen, deadline)) return false;
+            }
+        }
+
+        [[nodiscard]] bool set_decimation(std::uint32_t every_n, std::uint64_t min_interval_ns = 0) {
+            auto* GH = header();
+            auto* RS = reader_slot();
+            if (!GH || !RS) return false;
+            RS->due_frame.store(GH->frame_seq.load(std::memory_order_acquire), std::memory_order_relaxed);
+            RS->due_ns.store(0u, std::memory_order_relaxed);
+            RS->min_interval_ns.store(min_interval_ns, std::memory_order_release);
+            RS->every_n.store(every_n, std::memory_order_release);
+            doorbell_ring(RS->due_bell);
             return true;
         }
 
+        [[nodiscard]] bool decimated() {
+            const auto* RS = reader_slot();
+            return RS && filtered(*RS);
+        }
+
+        [[nodiscard]] bool interpolate(double sim_time, std::span<InterpStream> streams, InterpResult& res) {
+            const auto* GH = header();
+            if (!GH || !basic_sanity(*GH) || GH->slots < 2u) return false;
+            for (std::uint32_t attempt = 0; attempt < INTERP_RETRIES; ++attempt) {
+                const auto w = GH->write_index.load(std::memory_order_acquire);
+                FrameView fa, fb;
+                if (w == 0u || !slot_frame(*GH, w, fb)) return false;
+                const bool pair  = w >= 2u && slot_frame(*GH, w - 1u, fa) && fa.fh->frame_id.load(std::memory_order_acquire) < fb.fh->frame_id.load(std::memory_order_acquire);
+                const double ta  = pair ? fa.fh->sim_time : 0.0;
+                const double tb  = fb.fh->sim_time;
+                const double alp = pair && tb > ta ? std::clamp((sim_time - ta) / (tb - ta), 0.0, 1.0) : 1.0;
+                res              = InterpResult{pair ? fa.fh->frame_id.load(std::memory_order_acquire) : 0u, fb.fh->frame_id.load(std::memory_order_acquire), alp, !pair};
+                if (!decode(fb, interp_b_) || (pair && !decode(fa, interp_a_))) continue;
+                bool ok = true;
+                for (auto& s : streams) ok = interp_stream(s, pair ? &interp_a_ : nullptr, interp_b_, alp) && ok;
+                std::atomic_thread_fence(std::memory_order_acquire);
+                auto reserved = GH->reserve_index.load(std::memory_order_acquire);
+                if (reserved - w >= GH->slots || fb.fh->frame_id.load(std::memory_order_acquire) != res.frame_b) continue;
+                if (!pair || (reserved - (w - 1u) < GH->slots && fa.fh->frame_id.load(std::memory_order_acquire) == res.frame_a)) return ok;
+                ok = true;
+                for (auto& s : streams) ok = interp_stream(s, nullptr, interp_b_, alp) && ok;
+                std::atomic_thread_fence(std::memory_order_acquire);
+                reserved = GH->reserve_index.load(std::memory_order_acquire);
+                if (reserved - w >= GH->slots || fb.fh->frame_id.load(std::memory_order_acquire) != res.frame_b) continue;
+                res = InterpResult{0u, res.frame_b, 1.0, true};
+                return ok;
+            }
+            return false;
+        }
+
+        [[nodiscard]] bool subscribe(const StaticStreamInfo& info, bool on) {
+            auto* RS = reader_slot();
+            if (!RS || info.lod_op == LOD_NONE || info.lod_bit >= MAX_LOD_STREAMS) return false;
+            const auto bit = std::uint64_t{1} << info.lod_bit;
+            if (on)
+                RS->lod_mask.fetch_or(bit, std::memory_order_acq_rel);
+            else
+                RS->lod_mask.fetch_and(~bit, std::memory_order_acq_rel);
+            return true;
+        }
+
+        [[nodiscard]] std::uint64_t subscriptions() {
+            const auto* RS = reader_slot();
+            return RS ? RS->lod_mask.load(std::memory_order_acquire) : 0u;
+        }
+
+        [[nodiscard]] std::uint64_t frames_suppressed() noexcept {
+            const auto* GH = header();
+            return GH ? GH->frames_suppressed.load(std::memory_order_acquire) : 0u;
+        }
+
+        [[nodiscard]] bool set_lockstep(bool on) {
+            auto* GH = header();
+            auto* RS = reader_slot();
+            if (!GH || !RS) return false;
+            if (on) RS->acked_frame.store(GH->frame_seq.load(std::memory_order_acquire), std::memory_order_release);
+            RS->lockstep.store(on ? 1u : 0u, std::memory_order_release);
+            if (!on) doorbell_ring(GH->ack_bell);
+            return true;
+        }
+
+        [[nodiscard]] bool lockstep() {
+            const auto* RS = reader_slot();
+            return RS && RS->lockstep.load(std::memory_order_acquire) != 0u;
+        }
+
+        bool ack(std::uint64_t frame_id) {
+            auto* GH = header();
+            auto* RS = reader_slot();
+            if (!GH || !RS) return false;
+            RS->acked_frame.store(frame_id, std::memory_order_release);
+            doorbell_ring(GH->ack_bell);
+            return RS->lockstep.load(std::memory_order_acquire) != 0u;
+        }
+
+        [[nodiscard]] RpcFuture call(std::uint32_t method, const void* data, std::uint32_t bytes);
+
+        struct RpcCall {
+            std::uint32_t method;
+            const void* data;
+            std::uint32_t bytes;
+        };
+        [[nodiscard]] std::vector<RpcFuture> call_batch(std::span<const RpcCall> calls);
+
+        std::uint32_t rpc_pump() {
+            auto* GH = header();
+            if (!GH || GH->reply_per_reader == 0u || reader_slot_index_ == UINT32_MAX) return 0;
+            std::uint32_t budget = UINT32_MAX, n = 0;
+            (void) ring_drain(map_.data() + GH->reply_offset + reader_slot_index_ * GH->reply_stride, GH->reply_per_reader, budget, [&](std::uint32_t type, const std::uint8_t* body, std::uint32_t len) {
+                if (type != TLV_RPC_REPLY || len < sizeof(RpcHeader)) return;
+                RpcHeader rh{};
+                std::memcpy(&rh, body, sizeof(rh));
+                if (rh.call_id - call_base_ - 1u >= next_call_id_ - call_base_) return;
+                const auto it = rpc_pending_.find(rh.call_id);
+                if (it == rpc_pending_.end()) return;
+                it->second.status = rh.status;
+                it->second.data.assign(body + sizeof(rh), body + len);
+                ++n;
+            });
+            return n;
+        }
+
     private:
         static std::uint64_t now_ticks() noexcept {
             return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
@@ -218,14 +850,136 @@ namespace shmx {
             const auto mix        = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(&local) ^ static_cast<std::uintptr_t>(tid));
             return t ^ (mix * 0x9E3779B97F4A7C15ull);
         }
+        friend class RpcFuture;
+        friend class Selector;
+        struct RpcResult {
+            std::uint32_t status{RPC_PENDING};
+            std::vector<std::uint8_t> data;
+        };
+
+        bool control_push(std::uint32_t tlv_type, const void* data, std::uint32_t bytes) {
+            auto* GH = header();
+            if (!GH || GH->control_per_reader == 0) return false;
+            if (reader_slot_index_ == UINT32_MAX) {
+                if (!attach_slot()) return false;
+            }
+            auto* RS = reinterpret_cast<ReaderSlot*>(map_.data() + GH->readers_offset + reader_slot_index_ * GH->reader_slot_stride);
+            RS->heartbeat.store(now_ticks(), std::memory_order_release);
+            auto* const CH = map_.data() + GH->control_offset + reader_slot_index_ * GH->control_stride;
+            if (ring_push(CH, GH->control_per_reader, tlv_type, data, bytes)) return true;
+            [[maybe_unused]] const auto* r64 = reinterpret_cast<const std::atomic<std::uint64_t>*>(CH);
+            SHMX_PROBE3(control_full, reader_slot_index_, align_up(static_cast<std::uint32_t>(sizeof(TLV)) + bytes, 16), r64[1].load(std::memory_order_relaxed) - r64[0].load(std::memory_order_relaxed));
+            return false;
+        }
+        bool rpc_send(std::uint64_t call_id, std::uint32_t method, const void* data, std::uint32_t bytes) {
+            rpc_buf_.resize(sizeof(RpcHeader) + bytes);
+            const RpcHeader rh{call_id, method, RPC_PENDING};
+            std::memcpy(rpc_buf_.data(), &rh, sizeof(rh));
+            if (bytes) std::memcpy(rpc_buf_.data() + sizeof(rh), data, bytes);
+            return control_push(TLV_RPC_REQUEST, rpc_buf_.data(), static_cast<std::uint32_t>(rpc_buf_.size()));
+        }
+        Doorbell* reply_bell() {
+            auto* GH = header();
+            if (!GH || reader_slot_index_ == UINT32_MAX) return nullptr;
+            return &reinterpret_cast<ReaderSlot*>(map_.data() + GH->readers_offset + reader_slot_index_ * GH->reader_slot_stride)->reply_bell;
+        }
+
+        enum class KvRead { Empty, Miss, Hit, Fail };
+        static KvRead kv_read(const KvEntry* e, std::uint32_t value_cap, std::string_view key, std::uint64_t h, void* dst, std::uint32_t cap, std::uint32_t& bytes, std::uint32_t* version) noexcept {
+            Backoff backoff;
+            for (int attempt = 0; attempt < 64; ++attempt) {
+                const auto s1 = e->seq.load(std::memory_order_acquire);
+                if (s1 & 1u) {
+                    backoff.snooze();
+                    continue;
+                }
+                const auto state = e->state;
+                const auto klen  = e->key_len;
+                const auto vlen  = e->value_len;
+                const bool match = state == KV_LIVE && e->key_hash == h && klen == key.size() && std::memcmp(e->key, key.data(), key.size()) == 0;
+                if (match && vlen <= cap && vlen <= value_cap) std::memcpy(dst, reinterpret_cast<const std::uint8_t*>(e) + sizeof(KvEntry), vlen);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (e->seq.load(std::memory_order_relaxed) != s1) continue;
+                if (state == KV_EMPTY) return KvRead::Empty;
+                if (!match) return KvRead::Miss;
+                bytes = vlen;
+                if (version) *version = s1 >> 1u;
+                return vlen <= cap && vlen <= value_cap ? KvRead::Hit : KvRead::Fail;
+            }
+            return KvRead::Fail;
+        }
+        ReaderSlot* reader_slot() {
+            auto* GH = header();
+            if (!GH || reader_slot_index_ == UINT32_MAX) return nullptr;
+            return reinterpret_cast<ReaderSlot*>(map_.data() + GH->readers_offset + reader_slot_index_ * GH->reader_slot_stride);
+        }
+        bool slot_frame(const GlobalHeader& GH, std::uint32_t seq, FrameView& out) const noexcept {
+            const auto* base_slot = map_.data() + GH.slots_offset + ((seq - 1u) % GH.slots) * GH.slot_stride;
+            const auto* FH        = reinterpret_cast<const FrameHeader*>(base_slot);
+            const auto bytes      = FH->payload_bytes;
+            if (FH->frame_id.load(std::memory_order_acquire) == 0u || FH->session_id_copy != GH.session_id || bytes == 0u || bytes > GH.frame_bytes_cap) return false;
+            out = FrameView{FH, base_slot + align_up(static_cast<std::uint32_t>(sizeof(FrameHeader)), 64), bytes, false, 0u, seq};
+            return true;
+        }
+        static const DecodedItem* dense_item(const DecodedFrame& df, std::uint32_t stream_id) noexcept {
+            for (const auto& [sid, item] : df.streams)
+                if (sid == stream_id && item.encoding == ENC_DENSE) return &item;
+            return nullptr;
+        }
+        static bool interp_stream(InterpStream& s, const DecodedFrame* a, const DecodedFrame& b, double alpha) noexcept {
+            s.bytes = 0;
+            s.held  = false;
+            if ((s.dtype != DT_F32 && s.dtype != DT_F64) || !s.out) return false;
+            const auto vb  = dtype_size(s.dtype);
+            const auto* ib = dense_item(b, s.stream_id);
+            if (!ib || ib->bytes > s.capacity || ib->bytes % vb != 0u) return false;
+            const auto* ia = a ? dense_item(*a, s.stream_id) : nullptr;
+            if (ia && ia->bytes == ib->bytes && alpha < 1.0) {
+                if (s.dtype == DT_F32)
+                    simd::lerp(static_cast<float*>(s.out), static_cast<const float*>(ia->ptr), static_cast<const float*>(ib->ptr), ib->bytes / 4u, static_cast<float>(alpha));
+                else
+                    simd::lerp(static_cast<double*>(s.out), static_cast<const double*>(ia->ptr), static_cast<const double*>(ib->ptr), ib->bytes / 8u, alpha);
+            } else {
+                std::memcpy(s.out, ib->ptr, ib->bytes);
+                s.held = alpha < 1.0;
+            }
+            s.bytes = ib->bytes;
+            return true;
+        }
+        static bool filtered(const ReaderSlot& RS) noexcept {
+            return RS.every_n.load(std::memory_order_acquire) > 1u || RS.min_interval_ns.load(std::memory_order_acquire) != 0u;
+        }
+        Doorbell& wake_bell(GlobalHeader& GH) {
+            auto* RS = reader_slot();
+            return RS && filtered(*RS) ? RS->due_bell : GH.frame_bell;
+        }
+        std::uint64_t released_frame_id(const GlobalHeader& GH) {
+            const auto* RS = reader_slot();
+            return RS && filtered(*RS) ? RS->due_frame.load(std::memory_order_acquire) : published_frame_id(GH);
+        }
+        std::uint64_t published_frame_id(const GlobalHeader& GH) const noexcept {
+            const auto w = GH.write_index.load(std::memory_order_acquire);
+            if (w == 0u) return 0;
+            const auto* FH = reinterpret_cast<const FrameHeader*>(map_.data() + GH.slots_offset + ((w - 1u) % GH.slots) * GH.slot_stride);
+            return FH->frame_id.load(std::memory_order_acquire);
+        }
         void heartbeat_seen(std::uint64_t fid) {
             if (reader_slot_index_ == UINT32_MAX) return;
             const auto* GH = header();
             if (!GH) return;
             auto* RS = reinterpret_cast<ReaderSlot*>(map_.data() + GH->readers_offset + reader_slot_index_ * GH->reader_slot_stride);
+            if (RS->last_frame_seen.load(std::memory_order_relaxed) != fid) RS->frames_seen.fetch_add(1u, std::memory_order_relaxed);
             RS->last_frame_seen.store(fid, std::memory_order_release);
             RS->heartbeat.store(now_ticks(), std::memory_order_release);
         }
+        static const StructField* struct_field(const StaticStreamInfo& info, const DecodedItem& item, std::string_view name) noexcept {
+            if (!item.ptr || item.encoding != ENC_DENSE || info.elem_type != DT_STRUCT || info.bytes_per_elem == 0u) return nullptr;
+            const StructField* f = find_field(info, name);
+            if (!f) return nullptr;
+            const auto vb = dtype_size(f->dtype);
+            if (vb == 0u || f->count == 0u || static_cast<std::uint64_t>(f->offset) + static_cast<std::uint64_t>(vb) * f->count > info.bytes_per_elem) return nullptr;
+            return f;
+        }
         static bool basic_sanity(const GlobalHeader& H) noexcept {
             if (H.magic != MAGIC || H.ver_major != VER_MAJOR || H.ver_minor != VER_MINOR || H.endianness != ENDIAN_TAG) return false;
             if (H.slot_stride == 0u || H.slots_offset == 0u || H.frame_bytes_cap == 0u) return false;
@@ -255,8 +1009,22 @@ namespace shmx {
                     reader_slot_index_ = i;
                     reader_id_         = make_reader_id();
                     RS->reader_id.store(reader_id_, std::memory_order_release);
+                    RS->frames_seen.store(0u, std::memory_order_relaxed);
+                    RS->acked_frame.store(0u, std::memory_order_relaxed);
+                    RS->lockstep.store(0u, std::memory_order_relaxed);
+                    RS->lod_mask.store(0u, std::memory_order_relaxed);
+                    RS->every_n.store(0u, std::memory_order_relaxed);
+                    RS->min_interval_ns.store(0u, std::memory_order_relaxed);
                     RS->heartbeat.store(now_ticks(), std::memory_order_release);
+                    for (auto* ring : {GH->control_per_reader ? map_.data() + GH->control_offset + i * GH->control_stride : nullptr, GH->reply_per_reader ? map_.data() + GH->reply_offset + i * GH->reply_stride : nullptr}) {
+                        if (!ring) continue;
+                        auto* r64 = reinterpret_cast<std::atomic<std::uint64_t>*>(ring);
+                        r64[0].store(r64[1].load(std::memory_order_acquire), std::memory_order_release);
+                    }
+                    call_base_    = reader_id_;
+                    next_call_id_ = reader_id_;
                     GH->readers_connected.fetch_add(1u, std::memory_order_acq_rel);
+                    SHMX_PROBE2(reader_attach, reader_id_, i);
                     return true;
                 }
             }
@@ -270,8 +1038,15 @@ namespace shmx {
             RS->reader_id.store(0u, std::memory_order_release);
             RS->heartbeat.store(0u, std::memory_order_release);
             RS->last_frame_seen.store(0u, std::memory_order_release);
+            RS->frames_seen.store(0u, std::memory_order_release);
+            RS->lod_mask.store(0u, std::memory_order_release);
+            RS->every_n.store(0u, std::memory_order_release);
+            RS->min_interval_ns.store(0u, std::memory_order_release);
+            const bool was_lockstep = RS->lockstep.exchange(0u, std::memory_order_acq_rel) != 0u;
             RS->in_use.store(0u, std::memory_order_release);
             GH->readers_connected.fetch_sub(1u, std::memory_order_acq_rel);
+            if (was_lockstep) doorbell_ring(GH->ack_bell);
+            SHMX_PROBE2(reader_detach, reader_id_, reader_slot_index_);
             reader_slot_index_ = UINT32_MAX;
             reader_id_         = 0;
         }
@@ -280,6 +1055,88 @@ namespace shmx {
         GlobalHeader* GH_ = nullptr;
         std::uint32_t reader_slot_index_{UINT32_MAX};
         std::uint64_t reader_id_{0};
+        std::uint64_t next_call_id_{0}, call_base_{0};
+        std::uint64_t next_frame_id_{0};
+        DecodedFrame interp_a_, interp_b_;
+        std::unordered_map<std::uint64_t, RpcResult> rpc_pending_;
+        std::vector<std::uint8_t> rpc_buf_;
     };
+
+    inline RpcFuture Client::call(std::uint32_t method, const void* data, std::uint32_t bytes) {
+        if (!attach_slot()) return RpcFuture(RPC_SEND_FAILED);
+        const auto id = ++next_call_id_;
+        if (!rpc_send(id, method, data, bytes)) return RpcFuture(RPC_SEND_FAILED);
+        doorbell_ring(header()->control_bell);
+        rpc_pending_[id] = RpcResult{};
+        return RpcFuture(this, id);
+    }
+
+    inline std::vector<RpcFuture> Client::call_batch(std::span<const RpcCall> calls) {
+        std::vector<RpcFuture> out;
+        out.reserve(calls.size());
+        const bool attached = attach_slot();
+        bool sent           = false;
+        for (const auto& [method, data, bytes] : calls) {
+            const auto id = ++next_call_id_;
+            if (!attached || !rpc_send(id, method, data, bytes)) {
+                out.push_back(RpcFuture(RPC_SEND_FAILED));
+                continue;
+            }
+            rpc_pending_[id] = RpcResult{};
+            out.push_back(RpcFuture(this, id));
+            sent = true;
+        }
+        if (sent) doorbell_ring(header()->control_bell);
+        return out;
+    }
+
+    inline RpcFuture::~RpcFuture() {
+        if (cli_) cli_->rpc_pending_.erase(id_);
+    }
+
+    inline RpcFuture& RpcFuture::operator=(RpcFuture&& o) noexcept {
+        if (this != &o) {
+            if (cli_) cli_->rpc_pending_.erase(id_);
+            cli_    = std::exchange(o.cli_, nullptr);
+            id_     = o.id_;
+            status_ = o.status_;
+            data_   = std::move(o.data_);
+        }
+        return *this;
+    }
+
+    inline bool RpcFuture::ready() {
+        if (!cli_) return status_ != RPC_PENDING;
+        const auto it = cli_->rpc_pending_.find(id_);
+        if (it == cli_->rpc_pending_.end()) return false;
+        if (it->second.status == RPC_PENDING) {
+            cli_->rpc_pump();
+            if (it->second.status == RPC_PENDING) return false;
+        }
+        status_ = it->second.status;
+        data_   = std::move(it->second.data);
+        cli_->rpc_pending_.erase(it);
+        cli_ = nullptr;
+        return true;
+    }
+
+    inline bool RpcFuture::wait(std::uint64_t timeout_ns) {
+        if (ready()) return true;
+        if (!cli_) return false;
+        const auto deadline = deadline_after(timeout_ns);
+        Doorbell* bell      = cli_->reply_bell();
+        while (bell) {
+            const auto seen = bell->seq.load(std::memory_order_acquire);
+            if (ready()) return true;
+            if (!doorbell_wait_until(*bell, seen, deadline)) {
+                if (ready()) return true;
+                break;
+            }
+        }
+        cli_->rpc_pending_.erase(id_);
+        cli_    = nullptr;
+        status_ = RPC_TIMEOUT;
+        return false;
+    }
 } // namespace shmx
 #endif // SHMX_CLIENT_H
@@ -0,0 +1,433 @@
+#ifndef SHMX_COLUMNAR_H
+#define SHMX_COLUMNAR_H
+#include "shmx_client.h"
+#include "shmx_record.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace shmx {
+
+    inline constexpr std::uint64_t COLUMNAR_MAGIC   = 0x48494E415F434F4Cull;
+    inline constexpr std::uint32_t COLUMNAR_VERSION = 2;
+    inline constexpr std::uint32_t COLUMNAR_ALIGN   = 64;
+
+    inline constexpr std::uint32_t CHUNK_HAS_STATS = 1u;
+
+#pragma pack(push, 1)
+    struct ColumnarFileHeader {
+        std::uint64_t magic;
+        std::uint32_t version, reserved;
+    };
+    struct ColumnDesc {
+        std::uint32_t stream_id, dtype, components, bytes_per_elem, kind, name_len;
+    };
+    struct RowGroupDesc {
+        std::uint64_t first_row, rows;
+        std::uint64_t frame_ids_offset, sim_times_offset;
+        std::uint32_t chunk_begin, chunk_count;
+    };
+    struct ColumnChunkDesc {
+        std::uint32_t column, flags;
+        std::uint64_t values_offset, values_bytes, offsets_offset;
+        double min, max, sum;
+        std::uint64_t count, nan_count;
+    };
+    struct ColumnarTrailer {
+        std::uint64_t footer_offset, footer_bytes, rows;
+        std::uint32_t columns, row_groups, chunks, version;
+        std::uint64_t magic;
+    };
+#pragma pack(pop)
+
+    struct ColumnarOptions {
+        std::uint32_t row_group_rows{4096};
+        std::uint64_t row_group_bytes{64ull << 20};
+    };
+
+    struct ColumnarColumn {
+        ColumnDesc desc;
+        std::string name;
+    };
+
+    class ColumnarWriter {
+    public:
+        ColumnarWriter() = default;
+        ColumnarWriter(const ColumnarWriter&)            = delete;
+        ColumnarWriter& operator=(const ColumnarWriter&) = delete;
+        ~ColumnarWriter() {
+            if (f_) std::fclose(f_);
+        }
+
+        [[nodiscard]] bool open(const std::string& path, ColumnarOptions opt = {}) {
+            if (f_) return false;
+            f_ = std::fopen(path.c_str(), "wb");
+            if (!f_) return false;
+            buf_ = std::make_unique<char[]>(RECORD_IO_BUFFER);
+            std::setvbuf(f_, buf_.get(), _IOFBF, RECORD_IO_BUFFER);
+            opt_ = opt;
+            if (opt_.row_group_rows == 0u) opt_.row_group_rows = 1u;
+            const ColumnarFileHeader h{COLUMNAR_MAGIC, COLUMNAR_VERSION, 0u};
+            ok_  = std::fwrite(&h, sizeof(h), 1, f_) == 1;
+            pos_ = sizeof(h);
+            return ok_ && pad();
+        }
+
+        void set_directory(const std::vector<StaticStreamInfo>& dir) {
+            for (const auto& si : dir) {
+                if (by_stream_.contains(si.id)) continue;
+                by_stream_.emplace(si.id, static_cast<std::uint32_t>(cols_.size()));
+                auto& c = cols_.emplace_back();
+                c.meta  = ColumnarColumn{ColumnDesc{si.id, si.elem_type, si.components, si.bytes_per_elem, si.kind, static_cast<std::uint32_t>(si.name.size())}, si.name};
+                c.offsets.assign(group_rows_ + 1u, 0u);
+            }
+        }
+
+        bool append(std::uint64_t frame_id, double sim_time, const DecodedFrame& df) {
+            if (!f_ || !ok_) return false;
+            hits_.assign(cols_.size(), nullptr);
+            for (const auto& [sid, item] : df.streams) {
+                const auto it = by_stream_.find(sid);
+                if (it != by_stream_.end() && !hits_[it->second]) hits_[it->second] = &item;
+            }
+            for (std::uint32_t k = 0; k < cols_.size(); ++k) {
+                auto& c = cols_[k];
+                if (const auto* item = hits_[k]) {
+                    const bool had = item->encoding == ENC_DENSE ? append_dense(c, *item) : item->encoding == ENC_SAME ? append_same(c, *item) : append_sparse(c, *item, frame_id);
+                    if (had) c.last_frame = frame_id;
+                    else ++dropped_;
+                }
+                c.offsets.push_back(c.values.size());
+                group_bytes_ += c.offsets.back() - c.offsets[c.offsets.size() - 2u];
+            }
+            frame_ids_.push_back(frame_id);
+            sim_times_.push_back(sim_time);
+            prev_frame_ = frame_id;
+            ++group_rows_;
+            if (group_rows_ >= opt_.row_group_rows || group_bytes_ >= opt_.row_group_bytes) return flush_group();
+            return true;
+        }
+
+        bool close() {
+            if (!f_) return ok_;
+            if (group_rows_) (void) flush_group();
+            const auto footer_offset = pos_;
+            for (const auto& c : cols_) {
+                (void) write(&c.meta.desc, sizeof(ColumnDesc));
+                (void) write(c.meta.name.data(), c.meta.name.size());
+                (void) pad(8u);
+            }
+            (void) write(groups_.data(), groups_.size() * sizeof(RowGroupDesc));
+            (void) write(chunks_.data(), chunks_.size() * sizeof(ColumnChunkDesc));
+            const ColumnarTrailer t{footer_offset, pos_ - footer_offset, rows_, static_cast<std::uint32_t>(cols_.size()), static_cast<std::uint32_t>(groups_.size()), static_cast<std::uint32_t>(chunks_.size()), COLUMNAR_VERSION, COLUMNAR_MAGIC};
+            (void) write(&t, sizeof(t));
+            ok_ = std::fclose(f_) == 0 && ok_;
+            f_  = nullptr;
+            buf_.reset();
+            return ok_;
+        }
+
+        [[nodiscard]] std::uint64_t rows() const noexcept {
+            return rows_ + group_rows_;
+        }
+        [[nodiscard]] std::uint64_t dropped() const noexcept {
+            return dropped_;
+        }
+        [[nodiscard]] std::size_t row_groups() const noexcept {
+            return groups_.size();
+        }
+
+    private:
+        struct Column {
+            ColumnarColumn meta{};
+            std::vector<std::uint8_t> values, carry;
+            std::vector<std::uint64_t> offsets;
+            std::uint64_t last_frame = 0;
+        };
+
+        static bool append_dense(Column& c, const DecodedItem& item) {
+            const auto* p = static_cast<const std::uint8_t*>(item.ptr);
+            c.values.insert(c.values.end(), p, p + item.bytes);
+            return true;
+        }
+
+        static std::span<const std::uint8_t> last_row(const Column& c) noexcept {
+            const auto rows = c.offsets.size() - 1u;
+            if (!rows) return c.carry;
+            return {c.values.data() + c.offsets[rows - 1u], static_cast<std::size_t>(c.offsets[rows] - c.offsets[rows - 1u])};
+        }
+
+        bool append_same(Column& c, const DecodedItem& item) {
+            if (c.last_frame == 0u || c.last_frame != prev_frame_ || c.last_frame < same_frame_id(item)) return false;
+            const auto bytes = last_row(c).size();
+            const auto at    = c.values.size();
+            c.values.resize(at + bytes);
+            if (bytes) std::memcpy(c.values.data() + at, last_row(c).data(), bytes);
+            return true;
+        }
+
+        static bool append_sparse(Column& c, const DecodedItem& item, std::uint64_t frame_id) {
+            if (c.last_frame == 0u || c.last_frame + 1u != frame_id || item.bytes < sizeof(SparseHeader)) return false;
+            SparseHeader sh{};
+            std::memcpy(&sh, item.ptr, sizeof(sh));
+            const auto* body = static_cast<const std::uint8_t*>(item.ptr);
+            const auto dense = static_cast<std::size_t>(sh.dense_count) * sh.value_bytes;
+            const auto voff  = sparse_values_offset(item.elem_count);
+            const auto rows  = c.offsets.size() - 1u;
+            const auto prev  = last_row(c);
+            if (prev.size() != dense || item.elem_count > sh.dense_count || static_cast<std::uint64_t>(voff) + static_cast<std::uint64_t>(item.elem_count) * sh.value_bytes > item.bytes) return false;
+            const auto* idx = reinterpret_cast<const std::uint32_t*>(body + sizeof(SparseHeader));
+            if (item.elem_count && simd::max_index(idx, item.elem_count) >= sh.dense_count) return false;
+            const auto at = c.values.size();
+            c.values.resize(at + dense);
+            std::memcpy(c.values.data() + at, rows ? c.values.data() + c.offsets[rows - 1u] : c.carry.data(), dense);
+            simd::scatter(c.values.data() + at, body + voff, idx, item.elem_count, sh.value_bytes);
+            return true;
+        }
+
+        bool write(const void* p, std::size_t n) {
+            if (n == 0u) return ok_;
+            ok_ = ok_ && std::fwrite(p, n, 1, f_) == 1;
+            pos_ += n;
+            return ok_;
+        }
+
+        bool pad(std::uint32_t align = COLUMNAR_ALIGN) {
+            static constexpr std::uint8_t zeros[COLUMNAR_ALIGN] = {};
+            const auto rem = pos_ % align;
+            return rem == 0u || write(zeros, align - rem);
+        }
+
+        bool flush_group() {
+            RowGroupDesc g{rows_, group_rows_, 0u, 0u, static_cast<std::uint32_t>(chunks_.size()), 0u};
+            g.frame_ids_offset = pos_;
+            (void) write(frame_ids_.data(), frame_ids_.size() * sizeof(std::uint64_t));
+            (void) pad();
+            g.sim_times_offset = pos_;
+            (void) write(sim_times_.data(), sim_times_.size() * sizeof(double));
+            (void) pad();
+            for (std::uint32_t k = 0; k < cols_.size(); ++k) {
+                auto& c = cols_[k];
+                if (!c.values.empty()) {
+                    ColumnChunkDesc cd{k, 0u, pos_, c.values.size(), 0u, 0.0, 0.0, 0.0, 0u, 0u};
+                    simd::ValueStats st{};
+                    if (c.meta.desc.kind == STREAM_KIND_DENSE && simd::stats(c.meta.desc.dtype, c.values.data(), c.values.size(), st)) {
+                        cd.flags     = CHUNK_HAS_STATS;
+                        cd.min       = st.min;
+                        cd.max       = st.max;
+                        cd.sum       = st.sum;
+                        cd.count     = st.count;
+                        cd.nan_count = st.nan_count;
+                    }
+                    (void) write(c.values.data(), c.values.size());
+                    (void) pad();
+                    cd.offsets_offset = pos_;
+                    (void) write(c.offsets.data(), c.offsets.size() * sizeof(std::uint64_t));
+                    (void) pad();
+                    chunks_.push_back(cd);
+                }
+                const auto tail = c.offsets[group_rows_ - 1u];
+                c.carry.assign(c.values.begin() + static_cast<std::ptrdiff_t>(tail), c.values.end());
+                c.values.clear();
+                c.offsets.assign(1u, 0u);
+            }
+            g.chunk_count = static_cast<std::uint32_t>(chunks_.size()) - g.chunk_begin;
+            groups_.push_back(g);
+            rows_ += group_rows_;
+            group_rows_  = 0;
+            group_bytes_ = 0;
+            frame_ids_.clear();
+            sim_times_.clear();
+            return ok_;
+        }
+
+        std::FILE* f_ = nullptr;
+        std::unique_ptr<char[]> buf_;
+        ColumnarOptions opt_{};
+        std::vector<Column> cols_;
+        std::unordered_map<std::uint32_t, std::uint32_t> by_stream_;
+        std::vector<const DecodedItem*> hits_;
+        std::vector<std::uint64_t> frame_ids_;
+        std::vector<double> sim_times_;
+        std::vector<RowGroupDesc> groups_;
+        std::vector<ColumnChunkDesc> chunks_;
+        std::uint64_t pos_ = 0, rows_ = 0, group_rows_ = 0, group_bytes_ = 0, dropped_ = 0, prev_frame_ = 0;
+        bool ok_ = false;
+    };
+
+    class ColumnarFile {
+    public:
+        ColumnarFile() = default;
+        ColumnarFile(const ColumnarFile&)            = delete;
+        ColumnarFile& operator=(const ColumnarFile&) = delete;
+        ~ColumnarFile() {
+            close();
+        }
+
+        [[nodiscard]] bool open(const std::string& path) {
+            close();
+            if (!map_file(path)) return false;
+            if (!parse()) {
+                close();
+                return false;
+            }
+            return true;
+        }
+
+        void close() noexcept {
+#if defined(_WIN32)
+            if (base_) ::UnmapViewOfFile(base_);
+            if (hMap_) ::CloseHandle(hMap_);
+            if (hFile_ != INVALID_HANDLE_VALUE) ::CloseHandle(hFile_);
+            hMap_  = nullptr;
+            hFile_ = INVALID_HANDLE_VALUE;
+#else
+            if (base_) ::munmap(const_cast<std::uint8_t*>(base_), size_);
+#endif
+            base_ = nullptr;
+            size_ = 0;
+            columns_.clear();
+            groups_.clear();
+            chunks_.clear();
+            rows_ = 0;
+        }
+
+        [[nodiscard]] std::uint64_t rows() const noexcept {
+            return rows_;
+        }
+        [[nodiscard]] const std::vector<ColumnarColumn>& columns() const noexcept {
+            return columns_;
+        }
+        [[nodiscard]] const std::vector<RowGroupDesc>& row_groups() const noexcept {
+            return groups_;
+        }
+
+        [[nodiscard]] const ColumnarColumn* find_column(std::string_view name) const noexcept {
+            for (const auto& c : columns_)
+                if (c.name == name) return &c;
+            return nullptr;
+        }
+
+        [[nodiscard]] std::uint32_t column_index(const ColumnarColumn& c) const noexcept {
+            return static_cast<std::uint32_t>(&c - columns_.data());
+        }
+
+        [[nodiscard]] const ColumnChunkDesc* chunk(std::uint32_t group, std::uint32_t column) const noexcept {
+            if (group >= groups_.size()) return nullptr;
+            const auto& g = groups_[group];
+            for (std::uint32_t i = 0; i < g.chunk_count; ++i)
+                if (chunks_[g.chunk_begin + i].column == column) return &chunks_[g.chunk_begin + i];
+            return nullptr;
+        }
+
+        [[nodiscard]] std::span<const std::uint64_t> frame_ids(std::uint32_t group) const noexcept {
+            return {reinterpret_cast<const std::uint64_t*>(base_ + groups_[group].frame_ids_offset), static_cast<std::size_t>(groups_[group].rows)};
+        }
+        [[nodiscard]] std::span<const double> sim_times(std::uint32_t group) const noexcept {
+            return {reinterpret_cast<const double*>(base_ + groups_[group].sim_times_offset), static_cast<std::size_t>(groups_[group].rows)};
+        }
+        [[nodiscard]] std::span<const std::uint64_t> offsets(std::uint32_t group, const ColumnChunkDesc& cd) const noexcept {
+            return {reinterpret_cast<const std::uint64_t*>(base_ + cd.offsets_offset), static_cast<std::size_t>(groups_[group].rows + 1u)};
+        }
+        [[nodiscard]] std::span<const std::uint8_t> values(const ColumnChunkDesc& cd) const noexcept {
+            return {base_ + cd.values_offset, static_cast<std::size_t>(cd.values_bytes)};
+        }
+        template <class T>
+        [[nodiscard]] std::span<const T> values_as(const ColumnChunkDesc& cd) const noexcept {
+            return {reinterpret_cast<const T*>(base_ + cd.values_offset), static_cast<std::size_t>(cd.values_bytes / sizeof(T))};
+        }
+
+    private:
+        bool map_file(const std::string& path) {
+#if defined(_WIN32)
+            hFile_ = ::CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (hFile_ == INVALID_HANDLE_VALUE) return false;
+            LARGE_INTEGER sz{};
+            if (!::GetFileSizeEx(hFile_, &sz) || sz.QuadPart == 0) return false;
+            hMap_ = ::CreateFileMappingA(hFile_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (!hMap_) return false;
+            base_ = static_cast<const std::uint8_t*>(::MapViewOfFile(hMap_, FILE_MAP_READ, 0, 0, 0));
+            size_ = static_cast<std::size_t>(sz.QuadPart);
+#else
+            const int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) return false;
+            struct stat st{};
+            if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+                ::close(fd);
+                return false;
+            }
+            void* p = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+            ::close(fd);
+            if (p == MAP_FAILED) return false;
+            base_ = static_cast<const std::uint8_t*>(p);
+            size_ = static_cast<std::size_t>(st.st_size);
+#endif
+            return base_ != nullptr;
+        }
+
+        bool parse() {
+            ColumnarFileHeader h{};
+            ColumnarTrailer t{};
+            if (size_ < sizeof(h) + sizeof(t)) return false;
+            std::memcpy(&h, base_, sizeof(h));
+            std::memcpy(&t, base_ + size_ - sizeof(t), sizeof(t));
+            if (h.magic != COLUMNAR_MAGIC || h.version != COLUMNAR_VERSION || t.magic != COLUMNAR_MAGIC || t.version != COLUMNAR_VERSION) return false;
+            if (t.footer_offset > size_ - sizeof(t) || t.footer_bytes != size_ - sizeof(t) - t.footer_offset) return false;
+            const auto* cur = base_ + t.footer_offset;
+            const auto* end = base_ + size_ - sizeof(t);
+            for (std::uint32_t i = 0; i < t.columns; ++i) {
+                ColumnarColumn c{};
+                if (cur + sizeof(ColumnDesc) > end) return false;
+                std::memcpy(&c.desc, cur, sizeof(ColumnDesc));
+                cur += sizeof(ColumnDesc);
+                if (cur + c.desc.name_len > end) return false;
+                c.name.assign(reinterpret_cast<const char*>(cur), c.desc.name_len);
+                cur += c.desc.name_len;
+                cur += (8u - static_cast<std::size_t>(cur - base_) % 8u) % 8u;
+                columns_.push_back(std::move(c));
+            }
+            if (cur + t.row_groups * sizeof(RowGroupDesc) + t.chunks * sizeof(ColumnChunkDesc) != end) return false;
+            groups_.resize(t.row_groups);
+            chunks_.resize(t.chunks);
+            if (t.row_groups) std::memcpy(groups_.data(), cur, t.row_groups * sizeof(RowGroupDesc));
+            cur += t.row_groups * sizeof(RowGroupDesc);
+            if (t.chunks) std::memcpy(chunks_.data(), cur, t.chunks * sizeof(ColumnChunkDesc));
+            for (const auto& g : groups_) {
+                if (g.chunk_begin + static_cast<std::uint64_t>(g.chunk_count) > chunks_.size()) return false;
+                if (g.frame_ids_offset + g.rows * sizeof(std::uint64_t) > t.footer_offset || g.sim_times_offset + g.rows * sizeof(double) > t.footer_offset) return false;
+                for (std::uint32_t i = 0; i < g.chunk_count; ++i) {
+                    const auto& cd = chunks_[g.chunk_begin + i];
+                    if (cd.column >= columns_.size() || cd.values_offset + cd.values_bytes > t.footer_offset || cd.offsets_offset + (g.rows + 1u) * sizeof(std::uint64_t) > t.footer_offset) return false;
+                }
+            }
+            rows_ = t.rows;
+            return true;
+        }
+
+        const std::uint8_t* base_ = nullptr;
+        std::size_t size_         = 0;
+#if defined(_WIN32)
+        HANDLE hFile_ = INVALID_HANDLE_VALUE;
+        HANDLE hMap_  = nullptr;
+#endif
+        std::vector<ColumnarColumn> columns_;
+        std::vector<RowGroupDesc> groups_;
+        std::vector<ColumnChunkDesc> chunks_;
+        std::uint64_t rows_ = 0;
+    };
+
+} // namespace shmx
+#endif // SHMX_COLUMNAR_H
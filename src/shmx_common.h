@@ -1,11 +1,13 @@
 #ifndef SHMX_COMMON_H
 #define SHMX_COMMON_H
+#include "shmx_sync.h"
 #include <atomic>
 #include <cstdint>
 #include <cstring>
 #include <memory>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #if defined(_WIN32)
 #ifndef NOMINMAX
@@ -24,37 +26,98 @@ namespace shmx {
 
     inline constexpr std::uint64_t MAGIC        = 0x48494E415F53484Dull;
     inline constexpr std::uint32_t VER_MAJOR    = 2;
-    inline constexpr std::uint32_t VER_MINOR    = 0;
+    inline constexpr std::uint32_t VER_MINOR    = 9;
     inline constexpr std::uint32_t ENDIAN_TAG   = 0x01020304u;
     inline constexpr std::uint32_t ALIGN_STATIC = 64;
     inline constexpr std::uint32_t ALIGN_SLOT   = 64;
     inline constexpr std::uint32_t ALIGN_TLV    = 16;
 
-    inline constexpr std::uint32_t TLV_STATIC_DIR   = 0x1000;
-    inline constexpr std::uint32_t TLV_FRAME_STREAM = 0x2000;
-    inline constexpr std::uint32_t TLV_CONTROL_USER = 0x3000;
-
-    inline constexpr std::uint32_t DT_BOOL = 1;
-    inline constexpr std::uint32_t DT_I8   = 2;
-    inline constexpr std::uint32_t DT_U8   = 3;
-    inline constexpr std::uint32_t DT_I16  = 4;
-    inline constexpr std::uint32_t DT_U16  = 5;
-    inline constexpr std::uint32_t DT_I32  = 6;
-    inline constexpr std::uint32_t DT_U32  = 7;
-    inline constexpr std::uint32_t DT_I64  = 8;
-    inline constexpr std::uint32_t DT_U64  = 9;
-    inline constexpr std::uint32_t DT_F16  = 10;
-    inline constexpr std::uint32_t DT_BF16 = 11;
-    inline constexpr std::uint32_t DT_F32  = 12;
-    inline constexpr std::uint32_t DT_F64  = 13;
+    inline constexpr std::uint32_t TLV_STATIC_DIR    = 0x1000;
+    inline constexpr std::uint32_t TLV_STATIC_SHAPE  = 0x1001;
+    inline constexpr std::uint32_t TLV_STATIC_FIELDS = 0x1002;
+    inline constexpr std::uint32_t TLV_STATIC_LOD    = 0x1003;
+    inline constexpr std::uint32_t TLV_FRAME_STREAM  = 0x2000;
+    inline constexpr std::uint32_t TLV_FRAME_SPARSE  = 0x2001;
+    inline constexpr std::uint32_t TLV_FRAME_STATS   = 0x2002;
+    inline constexpr std::uint32_t TLV_FRAME_SAME    = 0x2003;
+    inline constexpr std::uint32_t TLV_CONTROL_USER  = 0x3000;
+    inline constexpr std::uint32_t TLV_RPC_REQUEST   = 0x3100;
+    inline constexpr std::uint32_t TLV_RPC_REPLY     = 0x3101;
+
+    inline constexpr std::uint32_t RPC_OK          = 0;
+    inline constexpr std::uint32_t RPC_NO_METHOD   = 1;
+    inline constexpr std::uint32_t RPC_FAILED      = 2;
+    inline constexpr std::uint32_t RPC_TIMEOUT     = 3;
+    inline constexpr std::uint32_t RPC_SEND_FAILED = 4;
+    inline constexpr std::uint32_t RPC_PENDING     = 0xFFFFFFFFu;
+
+    inline constexpr std::uint32_t DT_BOOL   = 1;
+    inline constexpr std::uint32_t DT_I8     = 2;
+    inline constexpr std::uint32_t DT_U8     = 3;
+    inline constexpr std::uint32_t DT_I16    = 4;
+    inline constexpr std::uint32_t DT_U16    = 5;
+    inline constexpr std::uint32_t DT_I32    = 6;
+    inline constexpr std::uint32_t DT_U32    = 7;
+    inline constexpr std::uint32_t DT_I64    = 8;
+    inline constexpr std::uint32_t DT_U64    = 9;
+    inline constexpr std::uint32_t DT_F16    = 10;
+    inline constexpr std::uint32_t DT_BF16   = 11;
+    inline constexpr std::uint32_t DT_F32    = 12;
+    inline constexpr std::uint32_t DT_F64    = 13;
+    inline constexpr std::uint32_t DT_STRUCT = 14;
 
     inline constexpr std::uint32_t LAYOUT_SOA_SCALAR = 0;
     inline constexpr std::uint32_t LAYOUT_AOS_VECTOR = 1;
 
+    inline constexpr std::uint32_t STREAM_KIND_DENSE  = 0;
+    inline constexpr std::uint32_t STREAM_KIND_RAGGED = 1;
+
+    inline constexpr std::uint32_t MAX_TENSOR_DIMS = 8;
+
+    inline constexpr std::uint32_t LOD_NONE        = 0;
+    inline constexpr std::uint32_t LOD_STRIDE      = 1;
+    inline constexpr std::uint32_t LOD_MEAN        = 2;
+    inline constexpr std::uint32_t LOD_MINMAX      = 3;
+    inline constexpr std::uint32_t MAX_LOD_STREAMS = 64;
+
+    inline constexpr std::uint32_t ENC_DENSE  = 0;
+    inline constexpr std::uint32_t ENC_SPARSE = 1;
+    inline constexpr std::uint32_t ENC_SAME   = 2;
+
+    inline constexpr std::uint32_t KV_CLASSES                 = 4;
+    inline constexpr std::uint32_t KV_KEY_MAX                 = 40;
+    inline constexpr std::uint32_t KV_CLASS_BYTES[KV_CLASSES] = {64, 256, 1024, 4096};
+    inline constexpr std::uint32_t KV_EMPTY                   = 0;
+    inline constexpr std::uint32_t KV_LIVE                    = 1;
+    inline constexpr std::uint32_t KV_DEAD                    = 2;
+
     constexpr std::uint32_t align_up(std::uint32_t x, std::uint32_t a) noexcept {
         return (x + (a - 1u)) & ~(a - 1u);
     }
 
+    constexpr std::uint64_t align_up64(std::uint64_t x, std::uint32_t a) noexcept {
+        return (x + (a - 1u)) & ~static_cast<std::uint64_t>(a - 1u);
+    }
+
+    constexpr std::uint32_t dtype_size(std::uint32_t dt) noexcept {
+        switch (dt) {
+        case DT_BOOL:
+        case DT_I8:
+        case DT_U8: return 1u;
+        case DT_I16:
+        case DT_U16:
+        case DT_F16:
+        case DT_BF16: return 2u;
+        case DT_I32:
+        case DT_U32:
+        case DT_F32: return 4u;
+        case DT_I64:
+        case DT_U64:
+        case DT_F64: return 8u;
+        default: return 0u;
+        }
+    }
+
     inline std::uint64_t fnv1a64(const void* data, std::size_t n) noexcept {
         const auto* p   = static_cast<const std::uint8_t*>(data);
         std::uint64_t h = 1469598103934665603ull;
@@ -76,13 +139,169 @@ namespace shmx {
         std::uint32_t length;
     };
     struct StaticStreamDesc {
-        std::uint32_t stream_id, element_type, components, layout, bytes_per_elem, reserved, name_len, extra_len;
+        std::uint32_t stream_id, element_type, components, layout, bytes_per_elem, kind, name_len, extra_len;
+    };
+    struct StaticShapeDesc {
+        std::uint32_t stream_id, ndim;
+        std::uint64_t extents[MAX_TENSOR_DIMS], strides[MAX_TENSOR_DIMS];
+    };
+    struct StaticFieldsHeader {
+        std::uint32_t stream_id, field_count;
+    };
+    struct StaticFieldDesc {
+        std::uint32_t dtype, count, offset, name_len;
+    };
+    struct StaticLodDesc {
+        std::uint32_t stream_id, source_id, op, factor, bit, reserved;
     };
     struct FrameStreamTLV {
         std::uint32_t stream_id, elem_count, bytes_payload, reserved;
     };
+    struct SparseHeader {
+        std::uint32_t dense_count, value_bytes, reserved[2];
+    };
+    struct StreamStatsTLV {
+        std::uint32_t stream_id, dtype;
+        double min, max, sum;
+        std::uint64_t count, nan_count;
+    };
+    struct RpcHeader {
+        std::uint64_t call_id;
+        std::uint32_t method, status;
+    };
 #pragma pack(pop)
 
+    constexpr std::uint64_t ragged_values_offset(std::uint32_t rows) noexcept {
+        constexpr auto head = static_cast<std::uint64_t>(sizeof(TLV) + sizeof(FrameStreamTLV));
+        return align_up64(head + (static_cast<std::uint64_t>(rows) + 1u) * sizeof(std::uint32_t), ALIGN_TLV) - head;
+    }
+
+    constexpr std::uint32_t sparse_values_offset(std::uint32_t nnz) noexcept {
+        constexpr auto head = static_cast<std::uint32_t>(sizeof(TLV) + sizeof(FrameStreamTLV) + sizeof(SparseHeader));
+        return align_up(head + nnz * static_cast<std::uint32_t>(sizeof(std::uint32_t)), ALIGN_TLV) - head + static_cast<std::uint32_t>(sizeof(SparseHeader));
+    }
+
+    inline constexpr std::uint32_t STATS_TLV_BYTES = align_up(static_cast<std::uint32_t>(sizeof(TLV) + sizeof(StreamStatsTLV)), ALIGN_TLV);
+    inline constexpr std::uint32_t SAME_TLV_BYTES  = align_up(static_cast<std::uint32_t>(sizeof(TLV) + sizeof(FrameStreamTLV) + sizeof(std::uint64_t)), ALIGN_TLV);
+
+    constexpr std::uint32_t frame_encoding(std::uint32_t tlv_type) noexcept {
+        return tlv_type == TLV_FRAME_SPARSE ? ENC_SPARSE : tlv_type == TLV_FRAME_SAME ? ENC_SAME : ENC_DENSE;
+    }
+
+    inline bool find_stream_stats(const std::uint8_t* payload, std::uint32_t bytes, std::uint32_t stream_id, StreamStatsTLV& out) noexcept {
+        const auto* cur = payload;
+        const auto* end = payload + bytes;
+        while (cur + sizeof(TLV) <= end) {
+            TLV tlv{};
+            std::memcpy(&tlv, cur, sizeof(TLV));
+            if (cur + sizeof(TLV) + tlv.length > end) return false;
+            if (tlv.type == TLV_FRAME_STATS && tlv.length >= sizeof(StreamStatsTLV)) {
+                std::memcpy(&out, cur + sizeof(TLV), sizeof(StreamStatsTLV));
+                if (out.stream_id == stream_id) return true;
+            }
+            cur += align_up(static_cast<std::uint32_t>(sizeof(TLV)) + tlv.length, ALIGN_TLV);
+        }
+        return false;
+    }
+
+    struct StructField {
+        std::string name;
+        std::uint32_t dtype{0}, offset{0}, count{1};
+    };
+
+    inline bool decode_struct_fields(const std::uint8_t* body, std::uint32_t len, std::uint32_t& stream_id, std::vector<StructField>& out) {
+        out.clear();
+        if (len < sizeof(StaticFieldsHeader)) return false;
+        StaticFieldsHeader fh{};
+        std::memcpy(&fh, body, sizeof(fh));
+        stream_id         = fh.stream_id;
+        std::uint32_t off = static_cast<std::uint32_t>(sizeof(fh));
+        for (std::uint32_t i = 0; i < fh.field_count; ++i) {
+            StaticFieldDesc fd{};
+            if (len - off < sizeof(fd)) return false;
+            std::memcpy(&fd, body + off, sizeof(fd));
+            off += static_cast<std::uint32_t>(sizeof(fd));
+            if (len - off < fd.name_len) return false;
+            const auto* name = reinterpret_cast<const char*>(body + off);
+            out.push_back(StructField{std::string(name, name + fd.name_len), fd.dtype, fd.offset, fd.count});
+            off += align_up(fd.name_len, 4);
+            if (off > len) off = len;
+        }
+        return true;
+    }
+
+    inline bool ring_push(std::uint8_t* ring, std::uint32_t cap, std::uint32_t type, const void* data, std::uint32_t bytes) noexcept {
+        auto* const r64 = reinterpret_cast<std::atomic<std::uint64_t>*>(ring);
+        auto* const w64 = r64 + 1;
+        const auto need = align_up(static_cast<std::uint32_t>(sizeof(TLV)) + bytes, 16);
+        const auto rv0  = r64->load(std::memory_order_acquire);
+        const auto wv0  = w64->load(std::memory_order_acquire);
+        if (((wv0 + need) - rv0) > (cap - 16u)) return false;
+        auto wv           = wv0;
+        auto off          = 16u + static_cast<std::uint32_t>(wv % (cap - 16u));
+        auto space_to_end = cap - off;
+        if (need > space_to_end) {
+            const auto span_to_end = (cap - 16u) - static_cast<std::uint32_t>(wv % (cap - 16u));
+            if (((wv + span_to_end) - rv0) > (cap - 16u)) return false;
+            if (space_to_end >= sizeof(TLV)) {
+                TLV pad{};
+                pad.type   = 0u;
+                pad.length = static_cast<std::uint32_t>(space_to_end - sizeof(TLV));
+                std::memcpy(ring + off, &pad, sizeof(TLV));
+                std::atomic_thread_fence(std::memory_order_release);
+            }
+            wv += span_to_end;
+            w64->store(wv, std::memory_order_release);
+            off = 16u;
+            if (((wv + need) - rv0) > (cap - 16u)) return false;
+        }
+        TLV tlv{};
+        tlv.type   = type;
+        tlv.length = bytes;
+        std::memcpy(ring + off, &tlv, sizeof(TLV));
+        if (bytes) std::memcpy(ring + off + sizeof(TLV), data, bytes);
+        std::atomic_thread_fence(std::memory_order_release);
+        wv += need;
+        w64->store(wv, std::memory_order_release);
+        return true;
+    }
+
+    template <class Fn>
+    bool ring_drain(std::uint8_t* ring, std::uint32_t cap, std::uint32_t& budget, Fn&& fn) {
+        auto* const r64 = reinterpret_cast<std::atomic<std::uint64_t>*>(ring);
+        auto* const w64 = r64 + 1;
+        const auto rv   = r64->load(std::memory_order_acquire);
+        const auto wv   = w64->load(std::memory_order_acquire);
+        auto rd         = rv;
+        bool ok         = true;
+        while (rd != wv && budget > 0u) {
+            auto off = 16u + static_cast<std::uint32_t>(rd % (cap - 16u));
+            if (off + sizeof(TLV) > cap) {
+                rd += static_cast<std::uint64_t>(cap - off);
+                off = 16u;
+            }
+            TLV tlv{};
+            std::memcpy(&tlv, ring + off, sizeof(TLV));
+            const auto body = align_up(static_cast<std::uint32_t>(sizeof(TLV)) + tlv.length, 16);
+            if (off + body > cap) {
+                if (tlv.type == 0u) {
+                    rd += static_cast<std::uint64_t>(cap - off);
+                    continue;
+                }
+                ok = false;
+                rd = wv;
+                break;
+            }
+            if (tlv.type != 0u) {
+                fn(tlv.type, ring + off + sizeof(TLV), tlv.length);
+                --budget;
+            }
+            rd += body;
+        }
+        if (rd != rv) r64->store(rd, std::memory_order_release);
+        return ok;
+    }
+
 #if defined(_MSC_VER)
 #pragma warning(push)
 #pragma warning(disable : 4324)
@@ -97,10 +316,19 @@ namespace shmx {
         std::uint32_t slots, slot_stride, slots_offset, frame_bytes_cap;
         std::uint32_t reader_slots, reader_slot_stride, readers_offset;
         std::uint32_t control_offset, control_per_reader, control_stride;
+        std::uint32_t reply_offset, reply_per_reader, reply_stride;
+        Doorbell control_bell;
         std::atomic<std::uint64_t> frame_seq;
         std::atomic<std::uint32_t> write_index;
         std::atomic<std::uint32_t> readers_connected;
         std::atomic<std::uint32_t> reserve_index;
+        std::atomic<std::uint64_t> bytes_published;
+        std::uint32_t kv_offset;
+        std::uint32_t kv_entries[KV_CLASSES];
+        std::uint32_t queue_offset, queue_cells, queue_cell_bytes;
+        std::uint32_t sync_offset, sync_cells;
+        Doorbell frame_bell, ack_bell;
+        std::atomic<std::uint64_t> frames_suppressed;
     };
     struct alignas(64) FrameHeader {
         std::uint64_t session_id_copy;
@@ -114,12 +342,43 @@ namespace shmx {
         std::atomic<std::uint64_t> reader_id, heartbeat, last_frame_seen;
         std::atomic<std::uint32_t> in_use;
         std::uint32_t pad;
-        std::uint64_t reserved[4];
+        std::atomic<std::uint64_t> frames_seen;
+        Doorbell reply_bell;
+        std::atomic<std::uint64_t> acked_frame;
+        std::atomic<std::uint32_t> lockstep;
+        std::uint32_t pad2;
+        std::atomic<std::uint64_t> lod_mask;
+        std::atomic<std::uint32_t> every_n;
+        std::uint32_t pad3;
+        std::atomic<std::uint64_t> min_interval_ns;
+        std::atomic<std::uint64_t> due_frame, due_ns;
+        Doorbell due_bell;
+    };
+    struct alignas(64) KvEntry {
+        std::atomic<std::uint32_t> seq;
+        std::uint32_t state, key_len, value_len;
+        std::uint64_t key_hash;
+        char key[KV_KEY_MAX];
     };
 #if defined(_MSC_VER)
 #pragma warning(pop)
 #endif
 
+    constexpr std::uint32_t kv_entry_stride(std::uint32_t cls) noexcept {
+        return static_cast<std::uint32_t>(sizeof(KvEntry)) + KV_CLASS_BYTES[cls];
+    }
+
+    inline std::uint32_t kv_class_offset(const GlobalHeader& H, std::uint32_t cls) noexcept {
+        std::uint32_t off = H.kv_offset;
+        for (std::uint32_t c = 0; c < cls; ++c) off += H.kv_entries[c] * kv_entry_stride(c);
+        return off;
+    }
+
+    inline std::uint64_t kv_hash(std::string_view key) noexcept {
+        const auto h = fnv1a64(key.data(), key.size());
+        return h ? h : 1u;
+    }
+
     class Map {
     public:
         Map() = default;
@@ -1,10 +1,16 @@
 #ifndef SHMX_INSPECTOR_H
 #define SHMX_INSPECTOR_H
 #include "shmx_common.h"
+#include "shmx_queue.h"
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <cmath>
 #include <cstdint>
+#include <deque>
 #include <limits>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace shmx {
@@ -19,17 +25,107 @@ namespace shmx {
         std::uint32_t control_offset;
         std::uint32_t control_stride;
         std::uint32_t control_per_reader;
+        std::uint32_t reply_offset;
+        std::uint32_t reply_stride;
+        std::uint32_t reply_per_reader;
         std::uint32_t slots_offset;
         std::uint32_t slot_stride;
         std::uint32_t slots;
         std::uint32_t frame_bytes_cap;
+        std::uint32_t kv_offset;
+        std::uint32_t kv_bytes;
+        std::uint32_t kv_entries[KV_CLASSES];
+        std::uint32_t queue_offset;
+        std::uint32_t queue_bytes;
+        std::uint32_t queue_cells;
+        std::uint32_t queue_cell_bytes;
+        std::uint32_t sync_offset;
+        std::uint32_t sync_cells;
+    };
+
+    struct InspectKvEntry {
+        std::string key;
+        std::uint32_t cls;
+        std::uint32_t index;
+        std::uint32_t value_len;
+        std::uint32_t version;
     };
 
     struct InspectReader {
         std::uint64_t reader_id;
         std::uint64_t heartbeat;
         std::uint64_t last_frame_seen;
+        std::uint64_t frames_seen;
+        std::uint64_t acked_frame;
+        std::uint64_t lod_mask;
+        std::uint64_t min_interval_ns;
+        std::uint32_t every_n;
         bool in_use;
+        bool lockstep;
+    };
+
+    struct InspectReaderSample {
+        std::uint32_t index;
+        std::uint64_t reader_id;
+        std::uint64_t last_frame_seen;
+        std::uint64_t frames_seen;
+        std::uint64_t control_used;
+        std::uint64_t min_interval_ns;
+        std::uint32_t every_n;
+    };
+
+    struct InspectSample {
+        std::uint64_t t_ns;
+        std::uint64_t frame_seq;
+        std::uint64_t frames_suppressed;
+        std::uint64_t bytes_published;
+        std::uint32_t slots;
+        std::uint32_t slots_valid;
+        std::uint32_t control_cap;
+        std::uint32_t frame_bytes_cap;
+        std::uint32_t frame_bytes_max;
+        std::vector<InspectReaderSample> readers;
+    };
+
+    struct InspectReaderRates {
+        std::uint32_t index;
+        std::uint64_t reader_id;
+        std::uint64_t lag;
+        std::uint64_t lag_p50;
+        std::uint64_t lag_p90;
+        std::uint64_t lag_p99;
+        std::uint64_t lag_max;
+        std::uint64_t drops;
+        double drop_rate;
+        double control_fill;
+    };
+
+    struct InspectRates {
+        double window_s;
+        double publish_hz;
+        double suppressed_hz;
+        double bytes_per_s;
+        std::uint32_t slots;
+        std::uint32_t slots_valid;
+        double control_fill_max;
+        std::vector<InspectReaderRates> readers;
+    };
+
+    struct InspectReaderAdvice {
+        std::uint32_t index;
+        std::uint64_t reader_id;
+        std::uint64_t lag_at_target;
+        std::uint32_t slots_needed;
+        double overrun_rate;
+        double drop_rate;
+    };
+
+    struct InspectAdvice {
+        double target;
+        std::uint64_t samples;
+        std::uint32_t slots, slots_recommended;
+        std::uint32_t frame_bytes_cap, frame_bytes_max, frame_bytes_cap_recommended;
+        std::vector<InspectReaderAdvice> readers;
     };
 
     struct InspectDirEntry {
@@ -38,8 +134,15 @@ namespace shmx {
         std::uint32_t components;
         std::uint32_t layout;
         std::uint32_t bytes_per_elem;
+        std::uint32_t kind;
         std::string name;
         std::vector<std::uint8_t> extra;
+        std::vector<std::uint64_t> shape;
+        std::vector<std::uint64_t> strides;
+        std::vector<StructField> fields;
+        std::uint32_t lod_op;
+        std::uint32_t lod_source;
+        std::uint32_t lod_factor;
     };
 
     struct InspectFrameView {
@@ -47,6 +150,18 @@ namespace shmx {
         const std::uint8_t* payload;
         std::uint32_t bytes;
         bool checksum_ok;
+        bool verified;
+    };
+
+    struct InspectSlotHeader {
+        std::uint32_t index;
+        std::uint64_t frame_id;
+        double sim_time;
+        std::uint32_t payload_bytes;
+        std::uint32_t tlv_count;
+        std::uint32_t checksum;
+        bool valid;
+        bool stable;
     };
 
     struct InspectSlotView {
@@ -64,6 +179,125 @@ namespace shmx {
         const void* ptr;
         std::uint32_t bytes;
         std::uint32_t elem_count;
+        std::uint32_t encoding;
+    };
+
+    class InspectStats {
+    public:
+        explicit InspectStats(std::chrono::nanoseconds window = std::chrono::seconds(10)) : window_ns_(static_cast<std::uint64_t>(window.count())) {}
+
+        void add(InspectSample smp) {
+            if (!samples_.empty() && smp.frame_seq < samples_.back().frame_seq) samples_.clear();
+            samples_.push_back(std::move(smp));
+            const auto now = samples_.back().t_ns;
+            while (samples_.size() > 2 && now - samples_.front().t_ns > window_ns_) samples_.pop_front();
+        }
+
+        void clear() noexcept {
+            samples_.clear();
+        }
+
+        [[nodiscard]] InspectRates rates() const {
+            InspectRates out{};
+            if (samples_.empty()) return out;
+            const auto& a = samples_.front();
+            const auto& b = samples_.back();
+            out.window_s  = static_cast<double>(b.t_ns - a.t_ns) * 1e-9;
+            if (out.window_s > 0.0) {
+                out.publish_hz    = static_cast<double>(b.frame_seq - a.frame_seq) / out.window_s;
+                out.suppressed_hz = static_cast<double>(b.frames_suppressed - a.frames_suppressed) / out.window_s;
+                out.bytes_per_s   = static_cast<double>(b.bytes_published - a.bytes_published) / out.window_s;
+            }
+            out.slots       = b.slots;
+            out.slots_valid = b.slots_valid;
+            std::vector<std::uint64_t> lags;
+            for (const auto& r : b.readers) {
+                InspectReaderRates rr{};
+                rr.index     = r.index;
+                rr.reader_id = r.reader_id;
+                rr.lag       = lag_of(b, r);
+                lags.clear();
+                const InspectReaderSample* first = nullptr;
+                const InspectSample* first_smp   = nullptr;
+                for (const auto& smp : samples_) {
+                    for (const auto& x : smp.readers) {
+                        if (x.index != r.index || x.reader_id != r.reader_id) continue;
+                        lags.push_back(lag_of(smp, x));
+                        if (!first) {
+                            first     = &x;
+                            first_smp = &smp;
+                        }
+                    }
+                }
+                if (!lags.empty()) {
+                    std::sort(lags.begin(), lags.end());
+                    auto pct   = [&](double p) { return lags[static_cast<std::size_t>(p * static_cast<double>(lags.size() - 1))]; };
+                    rr.lag_p50 = pct(0.50);
+                    rr.lag_p90 = pct(0.90);
+                    rr.lag_p99 = pct(0.99);
+                    rr.lag_max = lags.back();
+                }
+                if (first && first_smp != &b) {
+                    const auto published = b.frame_seq - first_smp->frame_seq;
+                    const auto seen      = r.frames_seen - first->frames_seen;
+                    rr.drops             = published > seen ? published - seen : 0u;
+                    rr.drop_rate         = published ? static_cast<double>(rr.drops) / static_cast<double>(published) : 0.0;
+                }
+                rr.control_fill      = b.control_cap ? static_cast<double>(r.control_used) / static_cast<double>(b.control_cap) : 0.0;
+                out.control_fill_max = std::max(out.control_fill_max, rr.control_fill);
+                out.readers.push_back(rr);
+            }
+            return out;
+        }
+
+        [[nodiscard]] InspectAdvice advise(double target = 0.01, double headroom = 0.25) const {
+            InspectAdvice out{};
+            out.target = target;
+            if (samples_.empty()) return out;
+            const auto R                    = rates();
+            const auto& b                   = samples_.back();
+            out.samples                     = samples_.size();
+            out.slots                       = b.slots;
+            out.slots_recommended           = 2u;
+            out.frame_bytes_cap             = b.frame_bytes_cap;
+            out.frame_bytes_cap_recommended = b.frame_bytes_cap;
+            for (const auto& smp : samples_) out.frame_bytes_max = std::max(out.frame_bytes_max, smp.frame_bytes_max);
+            if (out.frame_bytes_max) out.frame_bytes_cap_recommended = align_up(static_cast<std::uint32_t>(std::min(std::ceil(out.frame_bytes_max * (1.0 + headroom)), 4294967232.0)), 64);
+            std::vector<std::uint64_t> lags;
+            for (const auto& rr : R.readers) {
+                lags.clear();
+                for (const auto& smp : samples_) {
+                    for (const auto& x : smp.readers) {
+                        if (x.index != rr.index || x.reader_id != rr.reader_id || x.last_frame_seen == 0u) continue;
+                        const auto lag  = lag_of(smp, x);
+                        const auto idle = std::max<std::uint64_t>(std::max(x.every_n, 1u), static_cast<std::uint64_t>(static_cast<double>(x.min_interval_ns) * 1e-9 * R.publish_hz)) - 1u;
+                        lags.push_back(lag > idle ? lag - idle : 0u);
+                    }
+                }
+                if (lags.empty()) continue;
+                std::sort(lags.begin(), lags.end());
+                const auto over = lags.end() - std::lower_bound(lags.begin(), lags.end(), b.slots > 1u ? b.slots - 1u : 0u);
+                InspectReaderAdvice ra{};
+                ra.index              = rr.index;
+                ra.reader_id          = rr.reader_id;
+                ra.lag_at_target      = lags[static_cast<std::size_t>(std::clamp(1.0 - target, 0.0, 1.0) * static_cast<double>(lags.size() - 1))];
+                ra.slots_needed       = static_cast<std::uint32_t>(std::min<std::uint64_t>(ra.lag_at_target + 2u, std::numeric_limits<std::uint32_t>::max()));
+                ra.overrun_rate       = static_cast<double>(over) / static_cast<double>(lags.size());
+                ra.drop_rate          = rr.drop_rate;
+                out.slots_recommended = std::max(out.slots_recommended, ra.slots_needed);
+                out.readers.push_back(ra);
+            }
+            if (out.readers.empty()) out.slots_recommended = out.slots;
+            return out;
+        }
+
+    private:
+        static std::uint64_t lag_of(const InspectSample& smp, const InspectReaderSample& r) noexcept {
+            return smp.frame_seq > r.last_frame_seen ? smp.frame_seq - r.last_frame_seen : 0u;
+        }
+
+        std::uint64_t window_ns_;
+        std::deque<InspectSample> samples_;
     };
 
     class Inspector {
@@ -119,13 +353,49 @@ namespace shmx {
             L.control_offset     = H->control_offset;
             L.control_stride     = H->control_stride;
             L.control_per_reader = H->control_per_reader;
+            L.reply_offset       = H->reply_offset;
+            L.reply_stride       = H->reply_stride;
+            L.reply_per_reader   = H->reply_per_reader;
             L.slots_offset       = H->slots_offset;
             L.slot_stride        = H->slot_stride;
             L.slots              = H->slots;
             L.frame_bytes_cap    = H->frame_bytes_cap;
+            L.kv_offset          = H->kv_offset;
+            L.kv_bytes           = kv_class_offset(*H, KV_CLASSES) - H->kv_offset;
+            std::memcpy(L.kv_entries, H->kv_entries, sizeof(L.kv_entries));
+            L.queue_offset     = H->queue_offset;
+            L.queue_bytes      = H->queue_cells ? static_cast<std::uint32_t>(sizeof(QueueHeader)) + H->queue_cells * queue_cell_stride(H->queue_cell_bytes) : 0u;
+            L.queue_cells      = H->queue_cells;
+            L.queue_cell_bytes = H->queue_cell_bytes;
+            L.sync_offset      = H->sync_offset;
+            L.sync_cells       = H->sync_cells;
             return L;
         }
 
+        std::uint64_t queue_depth() const {
+            const auto* H = header();
+            if (!H || H->queue_cells == 0u) return 0;
+            return TaskQueue(map_.data() + H->queue_offset, H->queue_cells, H->queue_cell_bytes).size_approx();
+        }
+
+        std::vector<InspectKvEntry> list_kv() const {
+            std::vector<InspectKvEntry> out;
+            const auto* H = header();
+            if (!H) return out;
+            for (std::uint32_t c = 0; c < KV_CLASSES; ++c) {
+                const auto* base = map_.data() + kv_class_offset(*H, c);
+                for (std::uint32_t i = 0; i < H->kv_entries[c]; ++i) {
+                    const auto* e = reinterpret_cast<const KvEntry*>(base + static_cast<std::size_t>(i) * kv_entry_stride(c));
+                    const auto s1 = e->seq.load(std::memory_order_acquire);
+                    if ((s1 & 1u) || e->state != KV_LIVE) continue;
+                    InspectKvEntry ke{std::string(e->key, std::min(e->key_len, KV_KEY_MAX)), c, i, e->value_len, s1 >> 1u};
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (e->seq.load(std::memory_order_relaxed) == s1) out.push_back(std::move(ke));
+                }
+            }
+            return out;
+        }
+
         std::vector<InspectReader> snapshot_readers() const {
             std::vector<InspectReader> v;
             const auto* H = header();
@@ -137,16 +407,63 @@ namespace shmx {
                 r.reader_id       = RS->reader_id.load(std::memory_order_acquire);
                 r.heartbeat       = RS->heartbeat.load(std::memory_order_acquire);
                 r.last_frame_seen = RS->last_frame_seen.load(std::memory_order_acquire);
+                r.frames_seen     = RS->frames_seen.load(std::memory_order_acquire);
+                r.acked_frame     = RS->acked_frame.load(std::memory_order_acquire);
                 r.in_use          = RS->in_use.load(std::memory_order_acquire) != 0u;
+                r.lockstep        = RS->lockstep.load(std::memory_order_acquire) != 0u;
+                r.lod_mask        = RS->lod_mask.load(std::memory_order_acquire);
+                r.every_n         = RS->every_n.load(std::memory_order_acquire);
+                r.min_interval_ns = RS->min_interval_ns.load(std::memory_order_acquire);
                 v.push_back(r);
             }
             return v;
         }
 
+        InspectSample sample() const {
+            InspectSample smp{};
+            const auto* H = header();
+            if (!H) return smp;
+            smp.t_ns              = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+            smp.frame_seq         = H->frame_seq.load(std::memory_order_acquire);
+            smp.frames_suppressed = H->frames_suppressed.load(std::memory_order_acquire);
+            smp.bytes_published   = H->bytes_published.load(std::memory_order_relaxed);
+            smp.slots             = H->slots;
+            smp.control_cap       = H->control_per_reader > 16u ? H->control_per_reader - 16u : 0u;
+            smp.frame_bytes_cap   = H->frame_bytes_cap;
+            for (std::uint32_t i = 0; i < H->slots; ++i) {
+                const auto* FH = reinterpret_cast<const FrameHeader*>(map_.data() + H->slots_offset + i * H->slot_stride);
+                if (FH->session_id_copy != H->session_id || FH->frame_id.load(std::memory_order_acquire) == 0u) continue;
+                ++smp.slots_valid;
+                smp.frame_bytes_max = std::max(smp.frame_bytes_max, std::min(FH->payload_bytes, H->frame_bytes_cap));
+            }
+            for (std::uint32_t i = 0; i < H->reader_slots; ++i) {
+                auto* RS = reinterpret_cast<const ReaderSlot*>(map_.data() + H->readers_offset + i * H->reader_slot_stride);
+                if (RS->in_use.load(std::memory_order_acquire) == 0u) continue;
+                InspectReaderSample r{};
+                r.index           = i;
+                r.reader_id       = RS->reader_id.load(std::memory_order_acquire);
+                r.last_frame_seen = RS->last_frame_seen.load(std::memory_order_acquire);
+                r.frames_seen     = RS->frames_seen.load(std::memory_order_acquire);
+                r.every_n         = RS->every_n.load(std::memory_order_acquire);
+                r.min_interval_ns = RS->min_interval_ns.load(std::memory_order_acquire);
+                if (smp.control_cap) {
+                    auto* r64      = reinterpret_cast<const std::atomic<std::uint64_t>*>(map_.data() + H->control_offset + i * H->control_stride);
+                    const auto rv  = r64->load(std::memory_order_acquire);
+                    const auto wv  = (r64 + 1)->load(std::memory_order_acquire);
+                    r.control_used = wv >= rv ? wv - rv : 0u;
+                }
+                smp.readers.push_back(r);
+            }
+            return smp;
+        }
+
         std::vector<InspectDirEntry> decode_static_dir() const {
             std::vector<InspectDirEntry> out;
             const auto* H = header();
             if (!H) return out;
+            std::vector<StaticShapeDesc> shapes;
+            std::vector<std::pair<std::uint32_t, std::vector<StructField>>> fields;
+            std::vector<StaticLodDesc> lods;
             const std::uint8_t* cur = map_.data() + H->static_offset;
             const std::uint8_t* end = cur + H->static_bytes_used;
             while (cur + sizeof(TLV) <= end) {
@@ -166,29 +483,58 @@ namespace shmx {
                     de.components     = ss.components;
                     de.layout         = ss.layout;
                     de.bytes_per_elem = ss.bytes_per_elem;
+                    de.kind           = ss.kind;
                     de.name.assign(pName, pName + ss.name_len);
                     if (ss.extra_len) {
                         const auto* pExtra = reinterpret_cast<const std::uint8_t*>(pName + ss.name_len);
                         de.extra.assign(pExtra, pExtra + ss.extra_len);
                     }
                     out.push_back(std::move(de));
+                } else if (tlv.type == TLV_STATIC_SHAPE && tlv.length >= sizeof(StaticShapeDesc)) {
+                    StaticShapeDesc sd{};
+                    std::memcpy(&sd, cur + sizeof(TLV), sizeof(StaticShapeDesc));
+                    if (sd.ndim != 0u && sd.ndim <= MAX_TENSOR_DIMS) shapes.push_back(sd);
+                } else if (tlv.type == TLV_STATIC_FIELDS) {
+                    auto& [sid, list] = fields.emplace_back();
+                    if (!decode_struct_fields(cur + sizeof(TLV), tlv.length, sid, list)) fields.pop_back();
+                } else if (tlv.type == TLV_STATIC_LOD && tlv.length >= sizeof(StaticLodDesc)) {
+                    std::memcpy(&lods.emplace_back(), cur + sizeof(TLV), sizeof(StaticLodDesc));
                 }
                 cur += align_up(static_cast<std::uint32_t>(sizeof(TLV)) + tlv.length, 16);
             }
+            for (const auto& ld : lods) {
+                for (auto& de : out) {
+                    if (de.stream_id != ld.stream_id) continue;
+                    de.lod_op     = ld.op;
+                    de.lod_source = ld.source_id;
+                    de.lod_factor = ld.factor;
+                }
+            }
+            for (const auto& sd : shapes) {
+                for (auto& de : out) {
+                    if (de.stream_id != sd.stream_id) continue;
+                    de.shape.assign(sd.extents, sd.extents + sd.ndim);
+                    de.strides.assign(sd.strides, sd.strides + sd.ndim);
+                }
+            }
+            for (const auto& [sid, list] : fields) {
+                for (auto& de : out)
+                    if (de.stream_id == sid) de.fields = list;
+            }
             return out;
         }
 
-        bool latest(InspectFrameView& out) const {
+        bool latest(InspectFrameView& out, bool verify = false) const {
             const auto* H = header();
             if (!H) return false;
             if (H->slots == 0) return false;
             const auto w = H->write_index.load(std::memory_order_acquire);
             if (w == 0u) return false;
             const auto slot = (w - 1u) % H->slots;
-            return slot_view(static_cast<std::uint32_t>(slot), out);
+            return slot_view(static_cast<std::uint32_t>(slot), out, verify);
         }
 
-        bool slot_view(std::uint32_t slot, InspectFrameView& out) const {
+        bool slot_view(std::uint32_t slot, InspectFrameView& out, bool verify = false) const {
             const auto* H = header();
             if (!H) return false;
             if (slot >= H->slots) return false;
@@ -198,23 +544,74 @@ namespace shmx {
             const auto bytes      = FH->payload_bytes;
             if (bytes == 0 || bytes > H->frame_bytes_cap) return false;
             if (FH->session_id_copy != H->session_id) return false;
-            const auto calc = checksum32(payload, bytes);
-            out             = InspectFrameView{FH, payload, bytes, calc == FH->checksum};
+            out = InspectFrameView{FH, payload, bytes, false, false};
+            if (verify) (void) this->verify(out);
             return true;
         }
 
-        std::vector<InspectSlotView> list_slots() const {
+        bool slot_header(std::uint32_t slot, InspectSlotHeader& out) const {
+            const auto* H = header();
+            if (!H) return false;
+            if (slot >= H->slots) return false;
+            const auto* FH    = reinterpret_cast<const FrameHeader*>(map_.data() + H->slots_offset + slot * H->slot_stride);
+            const auto f1     = FH->frame_id.load(std::memory_order_acquire);
+            out.index         = slot;
+            out.frame_id      = f1;
+            out.sim_time      = FH->sim_time;
+            out.payload_bytes = FH->payload_bytes;
+            out.tlv_count     = FH->tlv_count;
+            out.checksum      = FH->checksum;
+            out.valid         = FH->session_id_copy == H->session_id && f1 != 0u && out.payload_bytes != 0u && out.payload_bytes <= H->frame_bytes_cap;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            out.stable = FH->frame_id.load(std::memory_order_relaxed) == f1;
+            return true;
+        }
+
+        std::vector<InspectSlotHeader> list_slot_headers() const {
+            std::vector<InspectSlotHeader> v;
+            const auto* H = header();
+            if (!H) return v;
+            v.reserve(H->slots);
+            for (std::uint32_t i = 0; i < H->slots; ++i) {
+                InspectSlotHeader sh{};
+                if (slot_header(i, sh)) v.push_back(sh);
+            }
+            return v;
+        }
+
+        std::vector<InspectSlotView> list_slots(bool verify = false) const {
             std::vector<InspectSlotView> v;
             const auto* H = header();
             if (!H) return v;
             v.reserve(H->slots);
             for (std::uint32_t i = 0; i < H->slots; ++i) {
                 InspectFrameView fv{};
-                if (slot_view(i, fv)) v.push_back(InspectSlotView{i, fv});
+                if (!slot_view(i, fv, verify)) continue;
+                v.push_back(InspectSlotView{i, fv});
             }
             return v;
         }
 
+        void set_verify_budget(std::uint64_t bytes_per_sec) noexcept {
+            verify_budget_ = bytes_per_sec;
+            verify_tokens_ = static_cast<double>(bytes_per_sec);
+            verify_last_   = 0;
+        }
+
+        bool verify(InspectFrameView& fv) const {
+            if (!fv.fh || !fv.payload) return false;
+            if (verify_budget_) {
+                const auto now = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+                if (verify_last_) verify_tokens_ = std::min(static_cast<double>(verify_budget_), verify_tokens_ + static_cast<double>(now - verify_last_) * 1e-9 * static_cast<double>(verify_budget_));
+                verify_last_ = now;
+                if (static_cast<double>(fv.bytes) > verify_tokens_) return false;
+                verify_tokens_ -= static_cast<double>(fv.bytes);
+            }
+            fv.checksum_ok = checksum32(fv.payload, fv.bytes) == fv.fh->checksum;
+            fv.verified    = true;
+            return true;
+        }
+
         static bool decode_frame(const InspectFrameView& fv, std::vector<std::pair<std::uint32_t, InspectItem>>& streams) {
             streams.clear();
             const auto* cur = fv.payload;
@@ -224,20 +621,24 @@ namespace shmx {
                 std::memcpy(&tlv, cur, sizeof(TLV));
                 const auto tlv_end = cur + sizeof(TLV) + tlv.length;
                 if (tlv_end > end) break;
-                if (tlv.type == TLV_FRAME_STREAM) {
+                if (tlv.type == TLV_FRAME_STREAM || tlv.type == TLV_FRAME_SPARSE || tlv.type == TLV_FRAME_SAME) {
                     if (tlv.length < sizeof(FrameStreamTLV)) break;
                     FrameStreamTLV fs{};
                     std::memcpy(&fs, cur + sizeof(TLV), sizeof(FrameStreamTLV));
                     const auto* body = cur + sizeof(TLV) + sizeof(FrameStreamTLV);
                     const auto have  = static_cast<std::size_t>(end - body);
                     if (have < fs.bytes_payload) break;
-                    streams.emplace_back(fs.stream_id, InspectItem{body, fs.bytes_payload, fs.elem_count});
+                    streams.emplace_back(fs.stream_id, InspectItem{body, fs.bytes_payload, fs.elem_count, frame_encoding(tlv.type)});
                 }
                 cur += align_up(static_cast<std::uint32_t>(sizeof(TLV)) + tlv.length, 16);
             }
             return true;
         }
 
+        static bool stream_stats(const InspectFrameView& fv, std::uint32_t stream_id, StreamStatsTLV& out) {
+            return fv.payload && find_stream_stats(fv.payload, fv.bytes, stream_id, out);
+        }
+
         std::vector<InspectControlMsg> peek_control(std::uint32_t reader_index, std::uint32_t max_msgs) const {
             std::vector<InspectControlMsg> out;
             const auto* H = header();
@@ -299,7 +700,10 @@ namespace shmx {
         }
 
         Map map_;
-        GlobalHeader* GH_ = nullptr;
+        GlobalHeader* GH_                  = nullptr;
+        std::uint64_t verify_budget_       = 16ull << 20;
+        mutable double verify_tokens_      = static_cast<double>(16ull << 20);
+        mutable std::uint64_t verify_last_ = 0;
     };
 
 } // namespace shmx
@@ -0,0 +1,30 @@
+#ifndef SHMX_PROBES_H
+#define SHMX_PROBES_H
+
+#if defined(SHMX_USDT) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define SHMX_PROBES_ENABLED 1
+#endif
+#endif
+
+#if defined(SHMX_PROBES_ENABLED)
+#define SHMX_PROBE1(name, a)          DTRACE_PROBE1(shmx, name, a)
+#define SHMX_PROBE2(name, a, b)       DTRACE_PROBE2(shmx, name, a, b)
+#define SHMX_PROBE3(name, a, b, c)    DTRACE_PROBE3(shmx, name, a, b, c)
+#define SHMX_PROBE4(name, a, b, c, d) DTRACE_PROBE4(shmx, name, a, b, c, d)
+#else
+#define SHMX_PROBE1(name, a)          ((void) 0)
+#define SHMX_PROBE2(name, a, b)       ((void) 0)
+#define SHMX_PROBE3(name, a, b, c)    ((void) 0)
+#define SHMX_PROBE4(name, a, b, c, d) ((void) 0)
+#endif
+
+namespace shmx {
+    inline constexpr int READ_FAIL_NO_FRAME = 1;
+    inline constexpr int READ_FAIL_BAD_SIZE = 2;
+    inline constexpr int READ_FAIL_SESSION  = 3;
+    inline constexpr int READ_FAIL_CHECKSUM = 4;
+} // namespace shmx
+
+#endif // SHMX_PROBES_H
@@ -0,0 +1,202 @@
+#ifndef SHMX_QUERY_H
+#define SHMX_QUERY_H
+#include "shmx_columnar.h"
+#include "shmx_simd.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace shmx {
+
+    class ThreadPool {
+    public:
+        explicit ThreadPool(std::uint32_t threads = 0) {
+            if (threads == 0u) threads = std::max(1u, std::thread::hardware_concurrency());
+            for (std::uint32_t i = 1; i < threads; ++i) workers_.emplace_back([this] { worker(); });
+        }
+        ThreadPool(const ThreadPool&)            = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+        ~ThreadPool() {
+            {
+                std::lock_guard lock(mu_);
+                stop_ = true;
+            }
+            cv_.notify_all();
+            for (auto& t : workers_) t.join();
+        }
+
+        [[nodiscard]] std::uint32_t size() const noexcept {
+            return static_cast<std::uint32_t>(workers_.size()) + 1u;
+        }
+
+        void run(std::uint32_t tasks, const std::function<void(std::uint32_t)>& fn) {
+            {
+                std::lock_guard lock(mu_);
+                job_   = &fn;
+                tasks_ = tasks;
+                next_.store(0u, std::memory_order_relaxed);
+                active_ = static_cast<std::uint32_t>(workers_.size());
+                ++gen_;
+            }
+            cv_.notify_all();
+            drain(fn, tasks);
+            std::unique_lock lock(mu_);
+            done_.wait(lock, [this] { return active_ == 0u; });
+            job_ = nullptr;
+        }
+
+    private:
+        void drain(const std::function<void(std::uint32_t)>& fn, std::uint32_t tasks) {
+            for (auto i = next_.fetch_add(1u, std::memory_order_relaxed); i < tasks; i = next_.fetch_add(1u, std::memory_order_relaxed)) fn(i);
+        }
+
+        void worker() {
+            std::uint64_t seen = 0;
+            for (;;) {
+                const std::function<void(std::uint32_t)>* job = nullptr;
+                std::uint32_t tasks                            = 0;
+                {
+                    std::unique_lock lock(mu_);
+                    cv_.wait(lock, [&] { return stop_ || gen_ != seen; });
+                    if (stop_) return;
+                    seen  = gen_;
+                    job   = job_;
+                    tasks = tasks_;
+                }
+                drain(*job, tasks);
+                std::lock_guard lock(mu_);
+                if (--active_ == 0u) done_.notify_one();
+            }
+        }
+
+        std::vector<std::thread> workers_;
+        std::mutex mu_;
+        std::condition_variable cv_, done_;
+        const std::function<void(std::uint32_t)>* job_ = nullptr;
+        std::uint32_t tasks_ = 0, active_ = 0;
+        std::atomic<std::uint32_t> next_{0};
+        std::uint64_t gen_ = 0;
+        bool stop_         = false;
+    };
+
+    struct QueryPredicate {
+        std::string column;
+        simd::CmpOp op{simd::CmpOp::Gt};
+        double value{0.0};
+    };
+
+    struct QuerySpec {
+        std::string column;
+        std::optional<QueryPredicate> where{};
+        bool collect_frames{false};
+    };
+
+    struct QueryResult {
+        simd::ValueStats agg{};
+        std::uint64_t rows_scanned{0}, rows_matched{0};
+        std::uint32_t groups{0}, groups_skipped{0}, groups_from_stats{0};
+        std::vector<std::uint64_t> frames{};
+    };
+
+    [[nodiscard]] inline bool zone_excludes(const ColumnChunkDesc& cd, simd::CmpOp op, double y) noexcept {
+        if (!(cd.flags & CHUNK_HAS_STATS)) return false;
+        switch (op) {
+        case simd::CmpOp::Gt: return cd.max <= y;
+        case simd::CmpOp::Ge: return cd.max < y;
+        case simd::CmpOp::Lt: return cd.min >= y;
+        case simd::CmpOp::Le: return cd.min > y;
+        case simd::CmpOp::Eq: return y < cd.min || y > cd.max;
+        case simd::CmpOp::Ne: return cd.nan_count == 0u && cd.min == y && cd.max == y;
+        }
+        return false;
+    }
+
+    [[nodiscard]] inline bool run_query(const ColumnarFile& cf, const QuerySpec& q, ThreadPool& pool, QueryResult& out) {
+        out                   = {};
+        const auto* target    = cf.find_column(q.column.empty() && q.where ? q.where->column : q.column);
+        const auto* where_col = q.where ? cf.find_column(q.where->column) : nullptr;
+        if (!target || (q.where && !where_col)) return false;
+        const auto numeric = [](const ColumnarColumn& c) { return c.desc.kind == STREAM_KIND_DENSE && simd::visit_numeric(c.desc.dtype, [](auto) {}); };
+        if (!numeric(*target) || (where_col && !numeric(*where_col))) return false;
+        const auto ti    = cf.column_index(*target);
+        const auto tsz   = dtype_size(target->desc.dtype);
+        const auto wi    = where_col ? cf.column_index(*where_col) : 0u;
+        const auto wsz   = where_col ? dtype_size(where_col->desc.dtype) : 1u;
+        const auto total = static_cast<std::uint32_t>(cf.row_groups().size());
+
+        struct GroupOut {
+            simd::ValueStats agg{};
+            std::uint64_t scanned = 0, matched = 0;
+            bool skipped = false, from_stats = false;
+            std::vector<std::uint64_t> frames;
+        };
+        std::vector<GroupOut> parts(total);
+        pool.run(total, [&](std::uint32_t g) {
+            auto& po        = parts[g];
+            const auto rows = cf.row_groups()[g].rows;
+            const auto* tc  = cf.chunk(g, ti);
+            if (!where_col) {
+                if (!tc) return;
+                const auto to   = cf.offsets(g, *tc);
+                const auto fids = cf.frame_ids(g);
+                for (std::uint64_t r = 0; r < rows; ++r) {
+                    if (to[r + 1u] == to[r]) continue;
+                    ++po.matched;
+                    if (q.collect_frames) po.frames.push_back(fids[r]);
+                }
+                if (tc->flags & CHUNK_HAS_STATS) {
+                    po.agg        = simd::ValueStats{tc->min, tc->max, tc->sum, tc->count, tc->nan_count};
+                    po.from_stats = true;
+                    return;
+                }
+                po.scanned   = rows;
+                const auto v = cf.values(*tc);
+                (void) simd::stats(target->desc.dtype, v.data(), v.size(), po.agg);
+                return;
+            }
+            const auto* wc = cf.chunk(g, wi);
+            if (!wc || zone_excludes(*wc, q.where->op, q.where->value)) {
+                po.skipped = true;
+                return;
+            }
+            po.scanned       = rows;
+            const auto wv    = cf.values(*wc);
+            const auto wo    = cf.offsets(g, *wc);
+            const auto fids  = cf.frame_ids(g);
+            const auto n_el  = wv.size() / wsz;
+            thread_local std::vector<std::uint8_t> mask;
+            mask.resize(n_el);
+            (void) simd::compare(where_col->desc.dtype, wv.data(), n_el, q.where->op, q.where->value, mask.data());
+            const auto tv = tc ? cf.values(*tc) : std::span<const std::uint8_t>{};
+            const auto to = tc ? cf.offsets(g, *tc) : std::span<const std::uint64_t>{};
+            for (std::uint64_t r = 0; r < rows; ++r) {
+                const auto b = wo[r] / wsz, e = wo[r + 1u] / wsz;
+                if (b == e || !std::memchr(mask.data() + b, 1, e - b)) continue;
+                ++po.matched;
+                if (tc && to[r + 1u] > to[r]) (void) simd::stats(target->desc.dtype, tv.data() + to[r], (to[r + 1u] - to[r]) / tsz * tsz, po.agg);
+                if (q.collect_frames) po.frames.push_back(fids[r]);
+            }
+        });
+
+        out.groups = total;
+        for (auto& po : parts) {
+            out.agg.merge(po.agg);
+            out.rows_scanned += po.scanned;
+            out.rows_matched += po.matched;
+            out.groups_skipped += po.skipped ? 1u : 0u;
+            out.groups_from_stats += po.from_stats ? 1u : 0u;
+            out.frames.insert(out.frames.end(), po.frames.begin(), po.frames.end());
+        }
+        return true;
+    }
+
+} // namespace shmx
+#endif // SHMX_QUERY_H
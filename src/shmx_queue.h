@@ -0,0 +1,155 @@
+#ifndef SHMX_QUEUE_H
+#define SHMX_QUEUE_H
+#include "shmx_common.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <span>
+
+namespace shmx {
+
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable : 4324)
+#endif
+    struct alignas(64) QueueHeader {
+        alignas(64) std::atomic<std::uint64_t> enqueue_pos;
+        alignas(64) std::atomic<std::uint64_t> dequeue_pos;
+        alignas(64) Doorbell not_empty;
+    };
+    struct QueueCell {
+        std::atomic<std::uint64_t> seq;
+        std::uint32_t bytes, reserved;
+    };
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
+
+    constexpr std::uint32_t queue_cell_stride(std::uint32_t cell_bytes) noexcept {
+        return align_up(static_cast<std::uint32_t>(sizeof(QueueCell)) + cell_bytes, 64);
+    }
+
+    struct QueueItem {
+        const void* data;
+        std::uint32_t bytes;
+    };
+
+    class TaskQueue {
+    public:
+        TaskQueue() = default;
+        TaskQueue(std::uint8_t* base, std::uint32_t cells, std::uint32_t cell_bytes) : hdr_(reinterpret_cast<QueueHeader*>(base)), cells_(base + sizeof(QueueHeader)), mask_(cells - 1u), cell_bytes_(cell_bytes), stride_(queue_cell_stride(cell_bytes)) {}
+
+        static void init(std::uint8_t* base, std::uint32_t cells, std::uint32_t cell_bytes) noexcept {
+            auto* h = new (base) QueueHeader{};
+            h->enqueue_pos.store(0u, std::memory_order_relaxed);
+            h->dequeue_pos.store(0u, std::memory_order_relaxed);
+            for (std::uint32_t i = 0; i < cells; ++i) {
+                auto* c = new (base + sizeof(QueueHeader) + static_cast<std::size_t>(i) * queue_cell_stride(cell_bytes)) QueueCell{};
+                c->seq.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        [[nodiscard]] bool valid() const noexcept {
+            return hdr_ != nullptr;
+        }
+        [[nodiscard]] std::uint32_t capacity() const noexcept {
+            return hdr_ ? mask_ + 1u : 0u;
+        }
+        [[nodiscard]] std::uint32_t cell_bytes() const noexcept {
+            return cell_bytes_;
+        }
+        [[nodiscard]] std::uint64_t size_approx() const noexcept {
+            if (!hdr_) return 0;
+            const auto d = hdr_->dequeue_pos.load(std::memory_order_acquire);
+            const auto e = hdr_->enqueue_pos.load(std::memory_order_acquire);
+            return e > d ? e - d : 0u;
+        }
+
+        [[nodiscard]] bool try_push(const void* data, std::uint32_t bytes) noexcept {
+            const QueueItem item{data, bytes};
+            return push_bulk(std::span<const QueueItem>(&item, 1)) == 1u;
+        }
+
+        std::uint32_t push_bulk(std::span<const QueueItem> items) noexcept {
+            if (!hdr_ || items.empty()) return 0;
+            std::uint32_t n = 0;
+            auto pos        = hdr_->enqueue_pos.load(std::memory_order_relaxed);
+            for (;;) {
+                n = 0;
+                while (n < items.size() && items[n].bytes <= cell_bytes_ && cell(pos + n)->seq.load(std::memory_order_acquire) == pos + n) ++n;
+                if (n == 0u) {
+                    const auto seq = cell(pos)->seq.load(std::memory_order_acquire);
+                    if (items[0].bytes > cell_bytes_ || static_cast<std::int64_t>(seq - pos) < 0) return 0;
+                    pos = hdr_->enqueue_pos.load(std::memory_order_relaxed);
+                    continue;
+                }
+                if (hdr_->enqueue_pos.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed)) break;
+            }
+            for (std::uint32_t i = 0; i < n; ++i) {
+                auto* c  = cell(pos + i);
+                c->bytes = items[i].bytes;
+                if (items[i].bytes) std::memcpy(payload(c), items[i].data, items[i].bytes);
+                c->seq.store(pos + i + 1u, std::memory_order_release);
+            }
+            doorbell_ring(hdr_->not_empty);
+            return n;
+        }
+
+        [[nodiscard]] bool try_pop(void* dst, std::uint32_t cap, std::uint32_t& bytes) noexcept {
+            return pop_bulk(dst, cap, std::span<std::uint32_t>(&bytes, 1)) == 1u;
+        }
+
+        std::uint32_t pop_bulk(void* dst, std::uint32_t cap_per_item, std::span<std::uint32_t> bytes) noexcept {
+            if (!hdr_ || bytes.empty() || cap_per_item < cell_bytes_) return 0;
+            std::uint32_t n = 0;
+            auto pos        = hdr_->dequeue_pos.load(std::memory_order_relaxed);
+            for (;;) {
+                n = 0;
+                while (n < bytes.size() && cell(pos + n)->seq.load(std::memory_order_acquire) == pos + n + 1u) ++n;
+                if (n == 0u) {
+                    const auto seq = cell(pos)->seq.load(std::memory_order_acquire);
+                    if (static_cast<std::int64_t>(seq - (pos + 1u)) < 0) return 0;
+                    pos = hdr_->dequeue_pos.load(std::memory_order_relaxed);
+                    continue;
+                }
+                if (hdr_->dequeue_pos.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed)) break;
+            }
+            auto* out = static_cast<std::uint8_t*>(dst);
+            for (std::uint32_t i = 0; i < n; ++i) {
+                auto* c  = cell(pos + i);
+                bytes[i] = c->bytes;
+                if (c->bytes) std::memcpy(out + static_cast<std::size_t>(i) * cap_per_item, payload(c), c->bytes);
+                c->seq.store(pos + i + mask_ + 1u, std::memory_order_release);
+            }
+            return n;
+        }
+
+        [[nodiscard]] bool pop_wait(void* dst, std::uint32_t cap, std::uint32_t& bytes, std::uint64_t timeout_ns) noexcept {
+            if (!hdr_) return false;
+            const auto deadline = deadline_after(timeout_ns);
+            for (;;) {
+                const auto seen = hdr_->not_empty.seq.load(std::memory_order_acquire);
+                if (try_pop(dst, cap, bytes)) return true;
+                if (!doorbell_wait_until(hdr_->not_empty, seen, deadline)) return try_pop(dst, cap, bytes);
+            }
+        }
+
+    private:
+        QueueCell* cell(std::uint64_t pos) const noexcept {
+            return reinterpret_cast<QueueCell*>(cells_ + static_cast<std::size_t>(pos & mask_) * stride_);
+        }
+        static std::uint8_t* payload(QueueCell* c) noexcept {
+            return reinterpret_cast<std::uint8_t*>(c) + sizeof(QueueCell);
+        }
+
+        QueueHeader* hdr_         = nullptr;
+        std::uint8_t* cells_      = nullptr;
+        std::uint32_t mask_       = 0;
+        std::uint32_t cell_bytes_ = 0;
+        std::uint32_t stride_     = 0;
+    };
+
+} // namespace shmx
+#endif // SHMX_QUEUE_H
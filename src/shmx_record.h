@@ -0,0 +1,139 @@
+#ifndef SHMX_RECORD_H
+#define SHMX_RECORD_H
+#include "shmx_client.h"
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace shmx {
+
+    inline constexpr std::uint64_t RECORD_MAGIC   = 0x48494E415F524543ull;
+    inline constexpr std::uint32_t RECORD_VERSION = 1;
+
+    inline constexpr std::uint32_t REC_STATIC = 1;
+    inline constexpr std::uint32_t REC_FRAME  = 2;
+
+    inline constexpr std::size_t RECORD_IO_BUFFER = 1u << 20;
+
+#pragma pack(push, 1)
+    struct RecordFileHeader {
+        std::uint64_t magic;
+        std::uint32_t version, reserved;
+        std::uint64_t session_id;
+    };
+    struct RecordChunk {
+        std::uint32_t kind, bytes;
+        std::uint64_t frame_id;
+        double sim_time;
+        std::uint32_t tlv_count, reserved;
+    };
+#pragma pack(pop)
+
+    class RecordWriter {
+    public:
+        RecordWriter() = default;
+        RecordWriter(const RecordWriter&)            = delete;
+        RecordWriter& operator=(const RecordWriter&) = delete;
+        ~RecordWriter() {
+            (void) close();
+        }
+
+        [[nodiscard]] bool open(const std::string& path, std::uint64_t session_id) {
+            (void) close();
+            f_ = std::fopen(path.c_str(), "wb");
+            if (!f_) return false;
+            buf_ = std::make_unique<char[]>(RECORD_IO_BUFFER);
+            std::setvbuf(f_, buf_.get(), _IOFBF, RECORD_IO_BUFFER);
+            const RecordFileHeader h{RECORD_MAGIC, RECORD_VERSION, 0u, session_id};
+            ok_ = std::fwrite(&h, sizeof(h), 1, f_) == 1;
+            return ok_;
+        }
+
+        bool write_static(const void* data, std::uint32_t bytes) {
+            return write_chunk(RecordChunk{REC_STATIC, bytes, 0u, 0.0, 0u, 0u}, data);
+        }
+
+        bool write_frame(std::uint64_t frame_id, double sim_time, std::uint32_t tlv_count, const void* payload, std::uint32_t bytes) {
+            return write_chunk(RecordChunk{REC_FRAME, bytes, frame_id, sim_time, tlv_count, 0u}, payload);
+        }
+
+        [[nodiscard]] std::uint64_t frames() const noexcept {
+            return frames_;
+        }
+
+        bool close() {
+            if (!f_) return ok_;
+            ok_ = std::fclose(f_) == 0 && ok_;
+            f_  = nullptr;
+            buf_.reset();
+            return ok_;
+        }
+
+    private:
+        bool write_chunk(const RecordChunk& c, const void* data) {
+            if (!f_ || !ok_) return false;
+            ok_ = std::fwrite(&c, sizeof(c), 1, f_) == 1 && (c.bytes == 0u || std::fwrite(data, c.bytes, 1, f_) == 1);
+            if (ok_ && c.kind == REC_FRAME) ++frames_;
+            return ok_;
+        }
+
+        std::FILE* f_ = nullptr;
+        std::unique_ptr<char[]> buf_;
+        std::uint64_t frames_ = 0;
+        bool ok_              = false;
+    };
+
+    class RecordReader {
+    public:
+        RecordReader() = default;
+        RecordReader(const RecordReader&)            = delete;
+        RecordReader& operator=(const RecordReader&) = delete;
+        ~RecordReader() {
+            close();
+        }
+
+        [[nodiscard]] bool open(const std::string& path) {
+            close();
+            f_ = std::fopen(path.c_str(), "rb");
+            if (!f_) return false;
+            buf_ = std::make_unique<char[]>(RECORD_IO_BUFFER);
+            std::setvbuf(f_, buf_.get(), _IOFBF, RECORD_IO_BUFFER);
+            RecordFileHeader h{};
+            if (std::fread(&h, sizeof(h), 1, f_) != 1 || h.magic != RECORD_MAGIC || h.version != RECORD_VERSION) {
+                close();
+                return false;
+            }
+            session_id_ = h.session_id;
+            return true;
+        }
+
+        [[nodiscard]] bool next(RecordChunk& chunk, std::vector<std::uint8_t>& body) {
+            if (!f_ || std::fread(&chunk, sizeof(chunk), 1, f_) != 1) return false;
+            body.resize(chunk.bytes);
+            return chunk.bytes == 0u || std::fread(body.data(), chunk.bytes, 1, f_) == 1;
+        }
+
+        [[nodiscard]] static FrameView frame_view(const RecordChunk& chunk, const std::vector<std::uint8_t>& body) noexcept {
+            return FrameView{nullptr, body.data(), chunk.bytes, false, 0u, 0u};
+        }
+
+        [[nodiscard]] std::uint64_t session_id() const noexcept {
+            return session_id_;
+        }
+
+        void close() noexcept {
+            if (f_) std::fclose(f_);
+            f_ = nullptr;
+            buf_.reset();
+        }
+
+    private:
+        std::FILE* f_ = nullptr;
+        std::unique_ptr<char[]> buf_;
+        std::uint64_t session_id_ = 0;
+    };
+
+} // namespace shmx
+#endif // SHMX_RECORD_H
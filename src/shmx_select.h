@@ -0,0 +1,129 @@
+#ifndef SHMX_SELECT_H
+#define SHMX_SELECT_H
+#include "shmx_client.h"
+#include "shmx_sync.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace shmx {
+
+    inline constexpr std::uint64_t SELECT_POLL_NS = 100000;
+
+    class Selector {
+    public:
+        Selector() = default;
+        Selector(const Selector&)            = delete;
+        Selector& operator=(const Selector&) = delete;
+
+        bool add(Client& cli) {
+            if (std::any_of(entries_.begin(), entries_.end(), [&](const Entry& e) { return e.client == &cli; })) return false;
+            entries_.push_back(Entry{&cli, 0u, 0u});
+            return true;
+        }
+
+        bool remove(Client& cli) {
+            const auto it = std::find_if(entries_.begin(), entries_.end(), [&](const Entry& e) { return e.client == &cli; });
+            if (it == entries_.end()) return false;
+            entries_.erase(it);
+            cursor_ = 0;
+            return true;
+        }
+
+        void clear() noexcept {
+            entries_.clear();
+            cursor_ = 0;
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept {
+            return entries_.size();
+        }
+
+        [[nodiscard]] bool wait(std::vector<Client*>& ready, std::uint64_t timeout_ns) {
+            ready.clear();
+            const auto deadline = deadline_after(timeout_ns);
+            Backoff backoff;
+            int woken = -1;
+            for (;;) {
+                const bool armed = arm();
+                if (armed && collect(ready, woken)) return true;
+                if (armed && backoff.spin()) continue;
+                const auto now = SyncClock::now();
+                if (now >= deadline) return false;
+                const auto left = std::min<std::uint64_t>(SELECT_POLL_NS, static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now).count()));
+                if (!armed) {
+                    std::this_thread::sleep_for(std::chrono::nanoseconds(left));
+                    continue;
+                }
+                for (auto* b : bells_) b->waiters.fetch_add(1u, std::memory_order_seq_cst);
+                bool moved = false;
+                for (std::size_t i = 0; i < bells_.size() && !moved; ++i) moved = bells_[i]->seq.load(std::memory_order_seq_cst) != seen_[i];
+                if (!moved) {
+                    const auto n = static_cast<std::uint32_t>(bells_.size());
+                    const int r  = futex_wait_any(words_.data(), seen_.data(), n, deadline);
+                    if (r >= 0)
+                        woken = armed_[static_cast<std::size_t>(r)];
+                    else if (r == WAIT_ANY_UNSUPPORTED)
+                        futex_wait(words_[0], seen_[0], left);
+                }
+                for (auto* b : bells_) b->waiters.fetch_sub(1u, std::memory_order_seq_cst);
+            }
+        }
+
+    private:
+        struct Entry {
+            Client* client;
+            std::uint64_t session_id, reported;
+        };
+
+        bool arm() {
+            bells_.clear();
+            words_.clear();
+            seen_.clear();
+            armed_.clear();
+            for (std::size_t i = 0; i < entries_.size(); ++i) {
+                auto& e  = entries_[i];
+                auto* GH = e.client->header();
+                if (!GH || !Client::basic_sanity(*GH) || GH->slots == 0u) continue;
+                if (GH->session_id != e.session_id) {
+                    e.session_id = GH->session_id;
+                    e.reported   = 0;
+                }
+                auto& bell = e.client->wake_bell(*GH);
+                bells_.push_back(&bell);
+                words_.push_back(&bell.seq);
+                seen_.push_back(bell.seq.load(std::memory_order_acquire));
+                armed_.push_back(static_cast<int>(i));
+            }
+            return !bells_.empty();
+        }
+
+        bool collect(std::vector<Client*>& ready, int woken) {
+            const auto n     = entries_.size();
+            const auto first = woken >= 0 ? static_cast<std::size_t>(woken) : cursor_ % n;
+            for (std::size_t k = 0; k < n; ++k) {
+                auto& e  = entries_[(first + k) % n];
+                auto* GH = e.client->header();
+                if (!GH || !Client::basic_sanity(*GH) || GH->session_id != e.session_id) continue;
+                const auto fid = e.client->released_frame_id(*GH);
+                if (fid <= e.reported) continue;
+                e.reported = fid;
+                ready.push_back(e.client);
+            }
+            if (ready.empty()) return false;
+            cursor_ = first + 1u;
+            return true;
+        }
+
+        std::vector<Entry> entries_;
+        std::vector<Doorbell*> bells_;
+        std::vector<std::atomic<std::uint32_t>*> words_;
+        std::vector<std::uint32_t> seen_;
+        std::vector<int> armed_;
+        std::size_t cursor_ = 0;
+    };
+
+} // namespace shmx
+#endif // SHMX_SELECT_H
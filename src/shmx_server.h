@@ -1,13 +1,23 @@
 #ifndef SHMX_SERVER_H
 #define SHMX_SERVER_H
 #include "shmx_common.h"
+#include "shmx_probes.h"
+#include "shmx_queue.h"
+#include "shmx_simd.h"
+#include "shmx_trace.h"
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <chrono>
 #include <cstring>
 #include <functional>
 #include <limits>
 #include <new>
+#include <span>
 #include <string>
 #include <thread>
+#include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -17,6 +27,11 @@ namespace shmx {
         std::uint32_t stream_id, element_type, components, layout, bytes_per_elem;
         std::string name_utf8;
         std::vector<std::uint8_t> extra;
+        std::uint32_t kind{STREAM_KIND_DENSE};
+        std::vector<std::uint64_t> shape{};
+        std::vector<std::uint64_t> strides{};
+        std::vector<StructField> fields{};
+        std::uint32_t lod_op{LOD_NONE}, lod_source{0}, lod_factor{0};
     };
 
     class Server {
@@ -26,7 +41,19 @@ namespace shmx {
             std::uint32_t slots{3}, reader_slots{16};
             std::uint32_t static_bytes_cap{0}, frame_bytes_cap{0};
             std::uint32_t control_per_reader{0};
+            std::uint32_t reply_per_reader{0};
+            std::array<std::uint32_t, KV_CLASSES> kv_entries{};
+            std::uint32_t queue_cells{0}, queue_cell_bytes{0};
+            std::uint32_t sync_cells{0};
+            bool stream_stats{false};
+            bool suppress_duplicates{false};
         };
+        struct RpcRequest {
+            std::uint64_t reader_id, call_id;
+            std::uint32_t method;
+            std::span<const std::uint8_t> data;
+        };
+        using RpcHandler = std::function<std::uint32_t(const RpcRequest&, std::vector<std::uint8_t>&)>;
         struct ControlMsg {
             std::uint64_t reader_id;
             std::uint32_t type;
@@ -44,18 +71,48 @@ namespace shmx {
             destroy();
             if (cfg.name.empty() || cfg.slots == 0u || cfg.frame_bytes_cap == 0u) return false;
 
-            const auto static_dir_bytes = build_static_dir(streams, static_dir_);
+            std::vector<StaticStream> resolved;
+            if (!resolve_lods(streams, resolved)) return false;
+            const auto static_dir_bytes = build_static_dir(resolved, static_dir_);
             if (cfg.static_bytes_cap && static_dir_bytes > cfg.static_bytes_cap) return false;
+            stats_dtypes_.clear();
+            if (cfg.stream_stats)
+                for (const auto& s : resolved)
+                    if (simd::visit_numeric(s.element_type, [](auto) {})) stats_dtypes_[s.stream_id] = s.element_type;
+            suppress_duplicates_ = cfg.suppress_duplicates;
+            seen_.clear();
+            seen_streams_ = 0;
+            same_streams_ = 0;
+            reuse_seq_    = 0;
 
             const auto slot_stride    = align_up(static_cast<std::uint32_t>(sizeof(FrameHeader)), 64) + align_up(cfg.frame_bytes_cap, 64);
             const auto readers_stride = align_up(static_cast<std::uint32_t>(sizeof(ReaderSlot)), 64);
             const auto control_stride = align_up(cfg.control_per_reader ? (cfg.control_per_reader) : 0u, 64);
+            const auto reply_stride   = align_up(cfg.reply_per_reader, 64);
+            if ((cfg.control_per_reader && cfg.control_per_reader <= 32u) || (cfg.reply_per_reader && cfg.reply_per_reader <= 32u)) return false;
 
             const auto static_off  = align_up(static_cast<std::uint32_t>(sizeof(GlobalHeader)), 64);
             const auto static_cap  = align_up(cfg.static_bytes_cap ? cfg.static_bytes_cap : static_dir_bytes, 64);
             const auto readers_off = align_up(static_off + static_cap, 64);
             const auto control_off = align_up(readers_off + cfg.reader_slots * readers_stride, 64);
-            const auto slots_off   = align_up(control_off + control_stride * cfg.reader_slots, 64);
+            const auto reply_off   = align_up(control_off + control_stride * cfg.reader_slots, 64);
+            const auto kv_off      = align_up(reply_off + reply_stride * cfg.reader_slots, 64);
+
+            std::array<std::uint32_t, KV_CLASSES> kv_entries{};
+            std::uint64_t kv_bytes = 0;
+            for (std::uint32_t c = 0; c < KV_CLASSES; ++c) {
+                if (cfg.kv_entries[c] > (1u << 24)) return false;
+                kv_entries[c] = cfg.kv_entries[c] ? std::bit_ceil(cfg.kv_entries[c]) : 0u;
+                kv_bytes += static_cast<std::uint64_t>(kv_entries[c]) * kv_entry_stride(c);
+            }
+            if (cfg.queue_cells > (1u << 24)) return false;
+            const auto queue_cells = cfg.queue_cells ? std::bit_ceil(cfg.queue_cells) : 0u;
+            const auto queue_bytes = queue_cells ? sizeof(QueueHeader) + static_cast<std::uint64_t>(queue_cells) * queue_cell_stride(cfg.queue_cell_bytes) : 0u;
+            const auto sync_bytes  = static_cast<std::uint64_t>(cfg.sync_cells) * SYNC_CELL_BYTES;
+            if (kv_off + kv_bytes + queue_bytes + sync_bytes > std::numeric_limits<std::uint32_t>::max()) return false;
+            const auto queue_off = align_up(kv_off + static_cast<std::uint32_t>(kv_bytes), 64);
+            const auto sync_off  = align_up(queue_off + static_cast<std::uint32_t>(queue_bytes), 64);
+            const auto slots_off = align_up(sync_off + static_cast<std::uint32_t>(sync_bytes), 64);
 
             const auto total64 = static_cast<std::uint64_t>(slots_off) + static_cast<std::uint64_t>(cfg.slots) * slot_stride;
             if (total64 > std::numeric_limits<std::uint32_t>::max()) return false;
@@ -84,10 +141,21 @@ namespace shmx {
             hdr_->control_offset     = control_off;
             hdr_->control_per_reader = cfg.control_per_reader;
             hdr_->control_stride     = control_stride;
+            hdr_->reply_offset       = reply_off;
+            hdr_->reply_per_reader   = cfg.reply_per_reader;
+            hdr_->reply_stride       = reply_stride;
+            hdr_->kv_offset          = kv_off;
+            std::memcpy(hdr_->kv_entries, kv_entries.data(), sizeof(hdr_->kv_entries));
+            hdr_->queue_offset     = queue_off;
+            hdr_->queue_cells      = queue_cells;
+            hdr_->queue_cell_bytes = cfg.queue_cell_bytes;
+            hdr_->sync_offset      = sync_off;
+            hdr_->sync_cells       = cfg.sync_cells;
             hdr_->frame_seq.store(0u, std::memory_order_relaxed);
             hdr_->write_index.store(0u, std::memory_order_relaxed);
             hdr_->readers_connected.store(0u, std::memory_order_relaxed);
             hdr_->reserve_index.store(0u, std::memory_order_relaxed);
+            hdr_->bytes_published.store(0u, std::memory_order_relaxed);
 
             if (!static_dir_.empty()) {
                 if (static_dir_.size() > static_cap) return false;
@@ -103,7 +171,27 @@ namespace shmx {
                 RS->heartbeat.store(0u, std::memory_order_relaxed);
                 RS->last_frame_seen.store(0u, std::memory_order_relaxed);
                 RS->in_use.store(0u, std::memory_order_relaxed);
+                RS->frames_seen.store(0u, std::memory_order_relaxed);
+                RS->acked_frame.store(0u, std::memory_order_relaxed);
+                RS->lockstep.store(0u, std::memory_order_relaxed);
+                RS->lod_mask.store(0u, std::memory_order_relaxed);
+                RS->every_n.store(0u, std::memory_order_relaxed);
+                RS->min_interval_ns.store(0u, std::memory_order_relaxed);
+                RS->due_frame.store(0u, std::memory_order_relaxed);
+                RS->due_ns.store(0u, std::memory_order_relaxed);
+                for (auto* ring : {cfg.control_per_reader ? map_.data() + control_off + i * control_stride : nullptr, cfg.reply_per_reader ? map_.data() + reply_off + i * reply_stride : nullptr}) {
+                    if (!ring) continue;
+                    auto* r64 = reinterpret_cast<std::atomic<std::uint64_t>*>(ring);
+                    r64[0].store(0u, std::memory_order_relaxed);
+                    r64[1].store(0u, std::memory_order_relaxed);
+                }
+            }
+            for (std::uint32_t c = 0; c < KV_CLASSES; ++c) {
+                auto* base = map_.data() + kv_class_offset(*hdr_, c);
+                for (std::uint32_t i = 0; i < kv_entries[c]; ++i) new (base + static_cast<std::size_t>(i) * kv_entry_stride(c)) KvEntry{};
             }
+            if (queue_cells) TaskQueue::init(map_.data() + queue_off, queue_cells, cfg.queue_cell_bytes);
+            if (sync_bytes) std::memset(map_.data() + sync_off, 0, static_cast<std::size_t>(sync_bytes));
             for (std::uint32_t s = 0; s < cfg.slots; ++s) {
                 auto* FH            = reinterpret_cast<FrameHeader*>(map_.data() + slots_off + s * slot_stride);
                 FH->session_id_copy = session_id_;
@@ -143,28 +231,90 @@ namespace shmx {
             return true;
         }
 
+        [[nodiscard]] bool kv_put(std::string_view key, const void* data, std::uint32_t bytes) const {
+            if (!hdr_ || key.empty() || key.size() > KV_KEY_MAX || (bytes && !data)) return false;
+            const auto h      = kv_hash(key);
+            KvEntry* cur      = nullptr;
+            std::uint32_t cls = 0;
+            for (; cls < KV_CLASSES; ++cls)
+                if ((cur = kv_find(cls, key, h))) break;
+            if (cur && KV_CLASS_BYTES[cls] >= bytes) {
+                kv_write(cur, KV_LIVE, key, h, data, bytes);
+                return true;
+            }
+            KvEntry* dst = nullptr;
+            for (std::uint32_t c = 0; c < KV_CLASSES && !dst; ++c)
+                if (KV_CLASS_BYTES[c] >= bytes) dst = kv_free_slot(c, h);
+            if (!dst) return false;
+            kv_write(dst, KV_LIVE, key, h, data, bytes);
+            if (cur) kv_write(cur, KV_DEAD, {}, 0u, nullptr, 0u);
+            return true;
+        }
+
+        template <class T>
+        [[nodiscard]] bool kv_put(std::string_view key, const T& value) const {
+            static_assert(std::is_trivially_copyable_v<T>);
+            return kv_put(key, &value, static_cast<std::uint32_t>(sizeof(T)));
+        }
+
+        bool kv_erase(std::string_view key) const {
+            if (!hdr_ || key.empty() || key.size() > KV_KEY_MAX) return false;
+            const auto h = kv_hash(key);
+            for (std::uint32_t c = 0; c < KV_CLASSES; ++c) {
+                if (auto* e = kv_find(c, key, h)) {
+                    kv_write(e, KV_DEAD, {}, 0u, nullptr, 0u);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        [[nodiscard]] TaskQueue queue() const noexcept {
+            if (!hdr_ || hdr_->queue_cells == 0u) return {};
+            return TaskQueue(map_.data() + hdr_->queue_offset, hdr_->queue_cells, hdr_->queue_cell_bytes);
+        }
+
+        template <class T> [[nodiscard]] T* sync_object(std::uint32_t index) const noexcept {
+            static_assert(std::is_standard_layout_v<T> && sizeof(T) <= SYNC_CELL_BYTES, "sync objects must be standard layout and fit one cell");
+            if (!hdr_ || index >= hdr_->sync_cells) return nullptr;
+            return reinterpret_cast<T*>(map_.data() + hdr_->sync_offset + static_cast<std::size_t>(index) * SYNC_CELL_BYTES);
+        }
+
+        [[nodiscard]] bool write_static_shape(std::uint32_t stream_id, const std::vector<std::uint64_t>& shape, const std::vector<std::uint64_t>& strides) const {
+            std::vector<std::uint8_t> tlv;
+            if (!append_shape_tlv(tlv, stream_id, shape, strides)) return false;
+            return write_static_append(tlv.data(), static_cast<std::uint32_t>(tlv.size()));
+        }
+
         struct FrameMap {
             FrameHeader* fh;
             std::uint8_t* payload;
             std::uint32_t capacity, slot, tlv_count, used;
             std::uint32_t seq;
+            const std::unordered_map<std::uint32_t, std::uint32_t>* stats_dtypes;
+            bool keyframe;
         };
 
         [[nodiscard]] FrameMap begin_frame() const {
-            const auto seq1 = hdr_->reserve_index.fetch_add(1u, std::memory_order_acq_rel) + 1u;
+            TraceScope ts(STAGE_BEGIN_FRAME);
+            const auto seq1 = reuse_seq_ && hdr_->reserve_index.load(std::memory_order_acquire) == reuse_seq_ ? std::exchange(reuse_seq_, 0u) : hdr_->reserve_index.fetch_add(1u, std::memory_order_acq_rel) + 1u;
             const auto slot = hdr_->slots ? ((seq1 - 1u) % hdr_->slots) : 0u;
             auto* base_slot = map_.data() + slots_off_ + slot * hdr_->slot_stride;
             auto* fh        = reinterpret_cast<FrameHeader*>(base_slot);
             auto* payload   = base_slot + align_up(static_cast<std::uint32_t>(sizeof(FrameHeader)), 64);
-            return FrameMap{fh, payload, hdr_->frame_bytes_cap, slot, 0u, 0u, static_cast<std::uint32_t>(seq1)};
+            ts.set_seq(static_cast<std::uint32_t>(seq1));
+            SHMX_PROBE2(begin_frame, seq1, slot);
+            return FrameMap{fh, payload, hdr_->frame_bytes_cap, slot, 0u, 0u, static_cast<std::uint32_t>(seq1), stats_dtypes_.empty() ? nullptr : &stats_dtypes_, false};
         }
 
         static bool append_stream(FrameMap& fm, std::uint32_t stream_id, const void* data, std::uint32_t elem_count, std::uint32_t elem_bytes_total) {
             if (!fm.fh || !data) return false;
+            TraceScope ts(STAGE_APPEND_STREAM, 0u, fm.seq, stream_id);
             constexpr std::uint32_t tlv_head  = sizeof(TLV);
             constexpr std::uint32_t body_head = sizeof(FrameStreamTLV);
             const auto need                   = align_up(tlv_head + body_head + elem_bytes_total, 16);
-            if (fm.used + need > fm.capacity) return false;
+            const auto stats_dt               = stats_dtype(fm, stream_id);
+            if (fm.used + need + (stats_dt ? STATS_TLV_BYTES : 0u) > fm.capacity) return false;
             auto* p = fm.payload + fm.used;
             TLV tlv{};
             tlv.type   = TLV_FRAME_STREAM;
@@ -179,35 +329,236 @@ namespace shmx {
             std::memcpy(p + tlv_head + body_head, data, elem_bytes_total);
             fm.used += need;
             fm.tlv_count += 1u;
+            if (stats_dt) append_stats(fm, stream_id, stats_dt, data, elem_bytes_total);
+            return true;
+        }
+
+        static bool append_ragged(FrameMap& fm, std::uint32_t stream_id, const std::uint32_t* offsets, std::uint32_t rows, const void* values, std::uint32_t values_bytes_total) {
+            if (!fm.fh || !offsets || (!values && values_bytes_total)) return false;
+            TraceScope ts(STAGE_APPEND_STREAM, 0u, fm.seq, stream_id);
+            constexpr std::uint32_t tlv_head  = sizeof(TLV);
+            constexpr std::uint32_t body_head = sizeof(FrameStreamTLV);
+            const auto values_off             = ragged_values_offset(rows);
+            const auto body64                 = values_off + values_bytes_total;
+            const auto need64                 = align_up64(tlv_head + body_head + body64, 16);
+            const auto stats_dt               = stats_dtype(fm, stream_id);
+            if (fm.used > fm.capacity || need64 + (stats_dt ? STATS_TLV_BYTES : 0u) > fm.capacity - fm.used) return false;
+            const auto body_bytes = static_cast<std::uint32_t>(body64);
+            const auto need       = static_cast<std::uint32_t>(need64);
+            auto* p               = fm.payload + fm.used;
+            TLV tlv{};
+            tlv.type   = TLV_FRAME_STREAM;
+            tlv.length = body_head + body_bytes;
+            std::memcpy(p, &tlv, sizeof(TLV));
+            FrameStreamTLV fs{};
+            fs.stream_id     = stream_id;
+            fs.elem_count    = rows;
+            fs.bytes_payload = body_bytes;
+            fs.reserved      = 0u;
+            std::memcpy(p + tlv_head, &fs, sizeof(FrameStreamTLV));
+            std::memcpy(p + tlv_head + body_head, offsets, (static_cast<std::size_t>(rows) + 1u) * sizeof(std::uint32_t));
+            if (values_bytes_total) std::memcpy(p + tlv_head + body_head + values_off, values, values_bytes_total);
+            fm.used += need;
+            fm.tlv_count += 1u;
+            if (stats_dt) append_stats(fm, stream_id, stats_dt, values, values_bytes_total);
+            return true;
+        }
+
+        static bool append_sparse(FrameMap& fm, std::uint32_t stream_id, const std::uint32_t* indices, std::uint32_t nnz, const void* values, std::uint32_t value_bytes, std::uint32_t dense_count) {
+            if (!fm.fh || value_bytes == 0u || (nnz && (!indices || !values))) return false;
+            if (nnz && indices[nnz - 1u] >= dense_count) return false;
+            TraceScope ts(STAGE_APPEND_STREAM, 0u, fm.seq, stream_id);
+            auto* p = reserve_sparse(fm, stream_id, nnz, value_bytes, dense_count);
+            if (!p) return false;
+            if (nnz) {
+                std::memcpy(p + sizeof(SparseHeader), indices, nnz * sizeof(std::uint32_t));
+                std::memcpy(p + sparse_values_offset(nnz), values, static_cast<std::size_t>(nnz) * value_bytes);
+            }
+            return true;
+        }
+
+        static bool append_sparse_diff(FrameMap& fm, std::uint32_t stream_id, const void* cur, const void* prev, std::uint32_t dense_count, std::uint32_t value_bytes, bool keyframe) {
+            if (!fm.fh || !cur || value_bytes == 0u) return false;
+            const auto dense_bytes = static_cast<std::uint64_t>(dense_count) * value_bytes;
+            if (dense_bytes > UINT32_MAX) return false;
+            const bool dense_fits = dense_bytes <= fm.capacity - std::min(fm.used, fm.capacity);
+            if (keyframe) fm.keyframe = true;
+            if (keyframe || !prev) return dense_fits && append_stream(fm, stream_id, cur, dense_count, static_cast<std::uint32_t>(dense_bytes));
+            TraceScope ts(STAGE_APPEND_STREAM, 0u, fm.seq, stream_id);
+            constexpr std::uint32_t head = sizeof(TLV) + sizeof(FrameStreamTLV) + sizeof(SparseHeader);
+            if (fm.used + head > fm.capacity) return false;
+            auto* idx          = reinterpret_cast<std::uint32_t*>(fm.payload + fm.used + head);
+            const auto max_nnz = std::min<std::uint64_t>((fm.capacity - fm.used - head) / (sizeof(std::uint32_t) + value_bytes), dense_count);
+            const auto* c      = static_cast<const std::uint8_t*>(cur);
+            const auto* q      = static_cast<const std::uint8_t*>(prev);
+            std::uint32_t nnz  = 0;
+            bool overflow      = false;
+            for (std::uint32_t i = 0; i < dense_count; ++i) {
+                if (std::memcmp(c + static_cast<std::size_t>(i) * value_bytes, q + static_cast<std::size_t>(i) * value_bytes, value_bytes) == 0) continue;
+                if (nnz == max_nnz) {
+                    overflow = true;
+                    break;
+                }
+                idx[nnz++] = i;
+            }
+            if (overflow || static_cast<std::uint64_t>(nnz) * (sizeof(std::uint32_t) + value_bytes) >= dense_bytes) return dense_fits && append_stream(fm, stream_id, cur, dense_count, static_cast<std::uint32_t>(dense_bytes));
+            auto* p = reserve_sparse(fm, stream_id, nnz, value_bytes, dense_count);
+            if (!p) return false;
+            simd::gather(p + sparse_values_offset(nnz), cur, idx, nnz, value_bytes);
+            return true;
+        }
+
+        class RaggedBuilder {
+        public:
+            RaggedBuilder() = default;
+
+            bool push_row(const void* data, std::uint32_t count) {
+                if (!base_ || row_ >= rows_ || (!data && count)) return false;
+                const auto bytes = static_cast<std::uint64_t>(count) * bytes_per_value_;
+                if (static_cast<std::uint64_t>(values_) + count > UINT32_MAX || bytes > static_cast<std::uint64_t>(limit_ - values_end())) return false;
+                if (bytes) std::memcpy(values_end(), data, static_cast<std::size_t>(bytes));
+                values_ += count;
+                ++row_;
+                store_offset(row_, values_);
+                return true;
+            }
+
+            [[nodiscard]] std::uint32_t rows_written() const noexcept {
+                return row_;
+            }
+
+        private:
+            friend class Server;
+            std::uint8_t* values_end() const noexcept {
+                return base_ + sizeof(TLV) + sizeof(FrameStreamTLV) + ragged_values_offset(rows_) + static_cast<std::uint64_t>(values_) * bytes_per_value_;
+            }
+            void store_offset(std::uint32_t row, std::uint32_t value) const noexcept {
+                std::memcpy(base_ + sizeof(TLV) + sizeof(FrameStreamTLV) + row * sizeof(std::uint32_t), &value, sizeof(value));
+            }
+
+            std::uint8_t* base_      = nullptr;
+            std::uint8_t* limit_     = nullptr;
+            std::uint32_t stream_id_ = 0, rows_ = 0, bytes_per_value_ = 0, row_ = 0, values_ = 0;
+        };
+
+        static RaggedBuilder begin_ragged(FrameMap& fm, std::uint32_t stream_id, std::uint32_t rows, std::uint32_t bytes_per_value) {
+            RaggedBuilder b{};
+            if (!fm.fh || bytes_per_value == 0u) return b;
+            const auto head = sizeof(TLV) + sizeof(FrameStreamTLV) + ragged_values_offset(rows);
+            if (fm.used > fm.capacity || head > fm.capacity - fm.used) return b;
+            b.base_            = fm.payload + fm.used;
+            b.limit_           = fm.payload + fm.capacity;
+            b.stream_id_       = stream_id;
+            b.rows_            = rows;
+            b.bytes_per_value_ = bytes_per_value;
+            b.store_offset(0u, 0u);
+            return b;
+        }
+
+        static bool end_ragged(FrameMap& fm, RaggedBuilder& b) {
+            if (!fm.fh || !b.base_ || b.base_ != fm.payload + fm.used) return false;
+            while (b.row_ < b.rows_) b.store_offset(++b.row_, b.values_);
+            constexpr std::uint32_t tlv_head  = sizeof(TLV);
+            constexpr std::uint32_t body_head = sizeof(FrameStreamTLV);
+            const auto values_bytes           = static_cast<std::uint64_t>(b.values_) * b.bytes_per_value_;
+            const auto body64                 = ragged_values_offset(b.rows_) + values_bytes;
+            const auto need64                 = align_up64(tlv_head + body_head + body64, 16);
+            const auto stats_dt               = stats_dtype(fm, b.stream_id_);
+            if (fm.used > fm.capacity || need64 + (stats_dt ? STATS_TLV_BYTES : 0u) > fm.capacity - fm.used) return false;
+            const auto body_bytes = static_cast<std::uint32_t>(body64);
+            const auto need       = static_cast<std::uint32_t>(need64);
+            TLV tlv{};
+            tlv.type   = TLV_FRAME_STREAM;
+            tlv.length = body_head + body_bytes;
+            std::memcpy(b.base_, &tlv, sizeof(TLV));
+            FrameStreamTLV fs{};
+            fs.stream_id     = b.stream_id_;
+            fs.elem_count    = b.rows_;
+            fs.bytes_payload = body_bytes;
+            fs.reserved      = 0u;
+            std::memcpy(b.base_ + tlv_head, &fs, sizeof(FrameStreamTLV));
+            fm.used += need;
+            fm.tlv_count += 1u;
+            if (stats_dt) append_stats(fm, b.stream_id_, stats_dt, b.base_ + tlv_head + body_head + ragged_values_offset(b.rows_), static_cast<std::uint32_t>(values_bytes));
+            b.base_ = nullptr;
             return true;
         }
 
         [[nodiscard]] bool publish_frame(FrameMap& fm, double sim_time) const {
             if (!hdr_ || !fm.fh) return false;
             if (fm.used > fm.capacity) return false;
-            const auto fid         = hdr_->frame_seq.fetch_add(1u, std::memory_order_relaxed) + 1u;
+            if (!lods_.empty()) append_lods(fm);
+            if (suppress_duplicates_ && suppress_unchanged(fm) && release_slot(fm)) return true;
+            TraceScope ts(STAGE_PUBLISH, 0u, fm.seq, fm.used);
+            const auto fid = hdr_->frame_seq.fetch_add(1u, std::memory_order_relaxed) + 1u;
+            ts.set_frame(fid);
+            if (suppress_duplicates_) remember_streams(fid);
             fm.fh->session_id_copy = hdr_->session_id;
             fm.fh->sim_time        = sim_time;
             fm.fh->payload_bytes   = fm.used;
             fm.fh->tlv_count       = fm.tlv_count;
-            fm.fh->checksum        = checksum32(fm.payload, fm.used);
+            {
+                TraceScope tc(STAGE_CHECKSUM, fid, fm.seq, fm.used);
+                fm.fh->checksum = checksum32(fm.payload, fm.used);
+            }
             std::atomic_thread_fence(std::memory_order_release);
             fm.fh->frame_id.store(fid, std::memory_order_release);
             hdr_->write_index.store(fm.seq, std::memory_order_release);
+            hdr_->bytes_published.fetch_add(fm.used, std::memory_order_relaxed);
+            doorbell_ring(hdr_->frame_bell);
+            release_filtered(fid);
+            SHMX_PROBE3(publish_frame, fid, fm.used, fm.slot);
             return true;
         }
 
+        [[nodiscard]] std::uint64_t last_frame_id() const noexcept {
+            return hdr_ ? hdr_->frame_seq.load(std::memory_order_acquire) : 0u;
+        }
+
+        [[nodiscard]] std::uint64_t frames_suppressed() const noexcept {
+            return hdr_ ? hdr_->frames_suppressed.load(std::memory_order_acquire) : 0u;
+        }
+
+        [[nodiscard]] std::uint32_t lockstep_pending(std::uint64_t frame_id) const noexcept {
+            if (!hdr_) return 0;
+            std::uint32_t n = 0;
+            for (std::uint32_t i = 0; i < hdr_->reader_slots; ++i) n += lockstep_lagging(reader_slot(i), frame_id) ? 1u : 0u;
+            return n;
+        }
+
+        [[nodiscard]] bool await_acks(std::uint64_t frame_id, std::uint64_t timeout_ns, bool evict = true) const {
+            if (!hdr_) return false;
+            const auto deadline = deadline_after(timeout_ns);
+            for (;;) {
+                const auto seen = hdr_->ack_bell.seq.load(std::memory_order_acquire);
+                if (lockstep_pending(frame_id) == 0u) return true;
+                if (!doorbell_wait_until(hdr_->ack_bell, seen, deadline)) break;
+            }
+            if (lockstep_pending(frame_id) == 0u) return true;
+            if (evict) {
+                for (std::uint32_t i = 0; i < hdr_->reader_slots; ++i) {
+                    auto* RS = reader_slot(i);
+                    if (!lockstep_lagging(RS, frame_id)) continue;
+                    RS->lockstep.store(0u, std::memory_order_release);
+                    SHMX_PROBE3(lockstep_evict, RS->reader_id.load(std::memory_order_acquire), i, frame_id);
+                }
+            }
+            return false;
+        }
+
         struct ReaderInfo {
             std::uint64_t reader_id, heartbeat, last_frame_seen;
             bool in_use;
+            bool lockstep;
+            std::uint64_t acked_frame;
         };
 
         [[nodiscard]] std::vector<ReaderInfo> snapshot_readers() const {
             std::vector<ReaderInfo> v;
             v.reserve(hdr_->reader_slots);
             for (std::uint32_t i = 0; i < hdr_->reader_slots; ++i) {
-                auto* RS = reinterpret_cast<ReaderSlot*>(map_.data() + readers_off_ + i * hdr_->reader_slot_stride);
-                v.push_back(ReaderInfo{RS->reader_id.load(std::memory_order_acquire), RS->heartbeat.load(std::memory_order_acquire), RS->last_frame_seen.load(std::memory_order_acquire), RS->in_use.load(std::memory_order_acquire) != 0u});
+                auto* RS = reader_slot(i);
+                v.push_back(ReaderInfo{RS->reader_id.load(std::memory_order_acquire), RS->heartbeat.load(std::memory_order_acquire), RS->last_frame_seen.load(std::memory_order_acquire), RS->in_use.load(std::memory_order_acquire) != 0u, RS->lockstep.load(std::memory_order_acquire) != 0u, RS->acked_frame.load(std::memory_order_acquire)});
             }
             return v;
         }
@@ -219,48 +570,31 @@ namespace shmx {
 
             bool ok_all = true;
             for (std::uint32_t i = 0; i < hdr_->reader_slots; ++i) {
-                auto* const CH  = map_.data() + hdr_->control_offset + i * hdr_->control_stride;
-                const auto cap  = hdr_->control_per_reader;
-                auto* const r64 = reinterpret_cast<std::atomic<std::uint64_t>*>(CH);
-                auto* const w64 = r64 + 1;
-
-                const auto rv = r64->load(std::memory_order_acquire);
-                const auto wv = w64->load(std::memory_order_acquire);
-                auto rd       = rv;
-
-                while (rd != wv && out.size() < max_msgs) {
-                    auto off = 16u + static_cast<std::uint32_t>(rd % (cap - 16u));
-                    if (off + sizeof(TLV) > cap) {
-                        rd += static_cast<std::uint64_t>(cap - off);
-                        off = 16u;
-                    }
-                    TLV tlv{};
-                    std::memcpy(&tlv, CH + off, sizeof(TLV));
-                    const auto body = align_up(static_cast<std::uint32_t>(sizeof(TLV)) + tlv.length, 16);
-                    if (off + body > cap) {
-                        if (tlv.type == 0u) {
-                            rd += static_cast<std::uint64_t>(cap - off);
-                            continue;
-                        }
-                        ok_all = false;
-                        rd     = wv;
-                        break;
-                    }
-                    if (tlv.type != 0u) {
-                        ControlMsg m{};
-                        m.reader_id = reader_id_of(i);
-                        m.type      = tlv.type;
-                        m.data.resize(tlv.length);
-                        std::memcpy(m.data.data(), CH + off + sizeof(TLV), tlv.length);
-                        out.push_back(std::move(m));
-                    }
-                    rd += body;
-                }
-                if (rd != rv) r64->store(rd, std::memory_order_release);
+                ok_all &= ring_drain(control_ring(i), hdr_->control_per_reader, max_msgs, [&](std::uint32_t type, const std::uint8_t* body, std::uint32_t len) {
+                    ControlMsg m{};
+                    m.reader_id = reader_id_of(i);
+                    m.type      = type;
+                    m.data.assign(body, body + len);
+                    out.push_back(std::move(m));
+                });
             }
+            SHMX_PROBE2(poll_control, out.size(), ok_all);
             return ok_all;
         }
 
+        void rpc_register(std::uint32_t method, RpcHandler handler) {
+            rpc_handlers_[method] = std::move(handler);
+        }
+
+        [[nodiscard]] std::uint32_t serve_rpc(std::vector<ControlMsg>& other, std::uint32_t max_msgs, std::uint64_t timeout_ns = 0) {
+            other.clear();
+            if (!hdr_ || hdr_->control_per_reader == 0u) return 0;
+            const auto seen = hdr_->control_bell.seq.load(std::memory_order_acquire);
+            auto served     = drain_rpc(other, max_msgs);
+            if (served == 0u && other.empty() && timeout_ns != 0u && doorbell_wait(hdr_->control_bell, seen, timeout_ns)) served = drain_rpc(other, max_msgs);
+            return served;
+        }
+
         [[nodiscard]] const GlobalHeader* header() const noexcept {
             return hdr_;
         }
@@ -283,18 +617,217 @@ namespace shmx {
                 const auto hb = RS->heartbeat.load(std::memory_order_acquire);
                 if (hb == 0) continue;
                 if (now_ticks > hb && now_ticks - hb > timeout_ticks) {
+                    SHMX_PROBE2(reader_reap, RS->reader_id.load(std::memory_order_acquire), i);
                     RS->reader_id.store(0u, std::memory_order_release);
                     RS->heartbeat.store(0u, std::memory_order_release);
                     RS->last_frame_seen.store(0u, std::memory_order_release);
+                    RS->frames_seen.store(0u, std::memory_order_release);
+                    RS->lockstep.store(0u, std::memory_order_release);
+                    RS->lod_mask.store(0u, std::memory_order_release);
+                    RS->every_n.store(0u, std::memory_order_release);
+                    RS->min_interval_ns.store(0u, std::memory_order_release);
                     RS->in_use.store(0u, std::memory_order_release);
                     hdr_->readers_connected.fetch_sub(1u, std::memory_order_acq_rel);
                     any = true;
                 }
             }
+            if (any) doorbell_ring(hdr_->ack_bell);
             return any;
         }
 
     private:
+        ReaderSlot* reader_slot(std::uint32_t i) const noexcept {
+            return reinterpret_cast<ReaderSlot*>(map_.data() + readers_off_ + i * hdr_->reader_slot_stride);
+        }
+        static bool lockstep_lagging(const ReaderSlot* RS, std::uint64_t frame_id) noexcept {
+            return RS->in_use.load(std::memory_order_acquire) != 0u && RS->lockstep.load(std::memory_order_acquire) != 0u && RS->acked_frame.load(std::memory_order_acquire) < frame_id;
+        }
+        void release_filtered(std::uint64_t frame_id) const noexcept {
+            std::uint64_t now = 0;
+            for (std::uint32_t i = 0; i < hdr_->reader_slots; ++i) {
+                auto* RS         = reader_slot(i);
+                const auto every = RS->every_n.load(std::memory_order_acquire);
+                const auto gap   = RS->min_interval_ns.load(std::memory_order_acquire);
+                if ((every <= 1u && gap == 0u) || RS->in_use.load(std::memory_order_acquire) == 0u) continue;
+                if (frame_id < RS->due_frame.load(std::memory_order_relaxed) + std::max(every, 1u)) continue;
+                if (gap) {
+                    if (!now) now = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(SyncClock::now().time_since_epoch()).count());
+                    if (now - RS->due_ns.load(std::memory_order_relaxed) < gap) continue;
+                    RS->due_ns.store(now, std::memory_order_relaxed);
+                }
+                RS->due_frame.store(frame_id, std::memory_order_release);
+                doorbell_ring(RS->due_bell);
+            }
+        }
+        struct LodPlan {
+            std::uint32_t stream_id, source_id, op, factor, bit;
+            std::uint32_t dtype, components, bytes_per_elem, out_bytes_per_elem;
+        };
+        bool resolve_lods(const std::vector<StaticStream>& in, std::vector<StaticStream>& out) {
+            out = in;
+            lods_.clear();
+            for (auto& s : out) {
+                if (s.lod_op == LOD_NONE) continue;
+                const auto src = std::find_if(in.begin(), in.end(), [&](const StaticStream& o) { return o.stream_id == s.lod_source && o.lod_op == LOD_NONE; });
+                if (src == in.end() || src->kind != STREAM_KIND_DENSE || src->bytes_per_elem == 0u || s.lod_op > LOD_MINMAX || s.lod_factor == 0u || lods_.size() == MAX_LOD_STREAMS) return false;
+                if (s.lod_op != LOD_STRIDE && (!simd::visit_numeric(src->element_type, [](auto) {}) || src->bytes_per_elem != dtype_size(src->element_type) * src->components)) return false;
+                const auto widen = s.lod_op == LOD_MINMAX ? 2u : 1u;
+                s.element_type   = src->element_type;
+                s.components     = src->components * widen;
+                s.layout         = src->layout;
+                s.bytes_per_elem = src->bytes_per_elem * widen;
+                s.kind           = STREAM_KIND_DENSE;
+                if (s.lod_op == LOD_STRIDE && s.fields.empty()) s.fields = src->fields;
+                lods_.push_back(LodPlan{s.stream_id, s.lod_source, s.lod_op, s.lod_factor, static_cast<std::uint32_t>(lods_.size()), src->element_type, src->components, src->bytes_per_elem, s.bytes_per_elem});
+            }
+            return true;
+        }
+        static const std::uint8_t* find_dense(const FrameMap& fm, std::uint32_t stream_id, FrameStreamTLV& fs) noexcept {
+            const std::uint8_t* found = nullptr;
+            for (std::uint32_t off = 0; off + sizeof(TLV) + sizeof(FrameStreamTLV) <= fm.used;) {
+                TLV tlv{};
+                std::memcpy(&tlv, fm.payload + off, sizeof(TLV));
+                if (tlv.type == TLV_FRAME_STREAM) {
+                    FrameStreamTLV cur{};
+                    std::memcpy(&cur, fm.payload + off + sizeof(TLV), sizeof(FrameStreamTLV));
+                    if (cur.stream_id == stream_id) {
+                        fs    = cur;
+                        found = fm.payload + off + sizeof(TLV) + sizeof(FrameStreamTLV);
+                    }
+                }
+                off += align_up(static_cast<std::uint32_t>(sizeof(TLV)) + tlv.length, ALIGN_TLV);
+            }
+            return found;
+        }
+        void append_lods(FrameMap& fm) const {
+            std::uint64_t mask = 0;
+            for (std::uint32_t i = 0; i < hdr_->reader_slots; ++i) {
+                const auto* RS = reader_slot(i);
+                if (RS->in_use.load(std::memory_order_acquire) != 0u) mask |= RS->lod_mask.load(std::memory_order_acquire);
+            }
+            if (!mask) return;
+            constexpr std::uint32_t head = sizeof(TLV) + sizeof(FrameStreamTLV);
+            for (const auto& l : lods_) {
+                if (!((mask >> l.bit) & 1u)) continue;
+                FrameStreamTLV src{};
+                const auto* data = find_dense(fm, l.source_id, src);
+                if (!data) continue;
+                const auto n        = src.bytes_payload / l.bytes_per_elem;
+                const auto blocks   = (n + l.factor - 1u) / l.factor;
+                const auto bytes    = blocks * l.out_bytes_per_elem;
+                const auto need     = align_up(head + bytes, ALIGN_TLV);
+                const auto stats_dt = stats_dtype(fm, l.stream_id);
+                if (n == 0u || fm.used + need + (stats_dt ? STATS_TLV_BYTES : 0u) > fm.capacity) {
+                    SHMX_PROBE2(lod_skip, l.stream_id, fm.seq);
+                    continue;
+                }
+                TraceScope ts(STAGE_APPEND_STREAM, 0u, fm.seq, l.stream_id);
+                auto* p = fm.payload + fm.used;
+                const TLV tlv{TLV_FRAME_STREAM, static_cast<std::uint32_t>(sizeof(FrameStreamTLV)) + bytes};
+                const FrameStreamTLV fs{l.stream_id, blocks, bytes, 0u};
+                std::memcpy(p, &tlv, sizeof(TLV));
+                std::memcpy(p + sizeof(TLV), &fs, sizeof(FrameStreamTLV));
+                (void) simd::downsample(l.op, l.dtype, p + head, data, n, l.components, l.bytes_per_elem, l.factor);
+                fm.used += need;
+                fm.tlv_count += 1u;
+                if (stats_dt) append_stats(fm, l.stream_id, stats_dt, p + head, bytes);
+            }
+        }
+        bool suppress_unchanged(FrameMap& fm) const {
+            fresh_.clear();
+            const auto next    = hdr_->frame_seq.load(std::memory_order_relaxed) + 1u;
+            std::uint32_t used = 0, tlvs = 0, same = 0;
+            bool other         = false;
+            for (std::uint32_t off = 0; off + sizeof(TLV) <= fm.used;) {
+                TLV tlv{};
+                std::memcpy(&tlv, fm.payload + off, sizeof(TLV));
+                const bool whole = sizeof(TLV) + static_cast<std::uint64_t>(tlv.length) <= fm.used - off;
+                const auto bytes = whole ? std::min(align_up(static_cast<std::uint32_t>(sizeof(TLV)) + tlv.length, ALIGN_TLV), fm.used - off) : fm.used - off;
+                auto* src        = fm.payload + off;
+                auto* dst        = fm.payload + used;
+                off += bytes;
+                ++tlvs;
+                if (whole && (tlv.type == TLV_FRAME_STREAM || tlv.type == TLV_FRAME_SPARSE) && tlv.length >= sizeof(FrameStreamTLV)) {
+                    FrameStreamTLV fs{};
+                    std::memcpy(&fs, src + sizeof(TLV), sizeof(FrameStreamTLV));
+                    const auto h  = simd::hash64(src, sizeof(TLV) + tlv.length);
+                    const auto it = seen_.find(fs.stream_id);
+                    if (!fm.keyframe && it != seen_.end() && it->second.hash == h && it->second.frame_id + hdr_->slots > next) {
+                        const TLV mark{TLV_FRAME_SAME, static_cast<std::uint32_t>(sizeof(FrameStreamTLV) + sizeof(std::uint64_t))};
+                        const FrameStreamTLV ms{fs.stream_id, fs.elem_count, static_cast<std::uint32_t>(sizeof(std::uint64_t)), 0u};
+                        std::memcpy(dst, &mark, sizeof(TLV));
+                        std::memcpy(dst + sizeof(TLV), &ms, sizeof(FrameStreamTLV));
+                        std::memcpy(dst + sizeof(TLV) + sizeof(FrameStreamTLV), &it->second.frame_id, sizeof(std::uint64_t));
+                        used += SAME_TLV_BYTES;
+                        ++same;
+                        continue;
+                    }
+                    fresh_.push_back({fs.stream_id, h});
+                } else if (tlv.type != TLV_FRAME_STATS) {
+                    other = true;
+                }
+                if (dst != src) std::memmove(dst, src, bytes);
+                used += bytes;
+            }
+            fm.used       = used;
+            fm.tlv_count  = tlvs;
+            same_streams_ = same;
+            return fresh_.empty() && !other && same != 0u && same == seen_streams_;
+        }
+        bool release_slot(FrameMap& fm) const noexcept {
+            if (hdr_->slots < 2u || hdr_->reserve_index.load(std::memory_order_acquire) != fm.seq) return false;
+            fm.fh->frame_id.store(0u, std::memory_order_release);
+            reuse_seq_ = fm.seq;
+            hdr_->frames_suppressed.fetch_add(1u, std::memory_order_release);
+            SHMX_PROBE2(frame_suppressed, fm.seq, fm.slot);
+            fm.fh = nullptr;
+            return true;
+        }
+        void remember_streams(std::uint64_t frame_id) const {
+            seen_streams_ = same_streams_ + static_cast<std::uint32_t>(fresh_.size());
+            for (const auto& f : fresh_) seen_[f.stream_id] = SeenStream{f.hash, frame_id};
+        }
+        static std::uint32_t stats_dtype(const FrameMap& fm, std::uint32_t stream_id) noexcept {
+            if (!fm.stats_dtypes) return 0u;
+            const auto it = fm.stats_dtypes->find(stream_id);
+            return it == fm.stats_dtypes->end() ? 0u : it->second;
+        }
+        static void append_stats(FrameMap& fm, std::uint32_t stream_id, std::uint32_t dtype, const void* data, std::uint32_t bytes) noexcept {
+            simd::ValueStats st{};
+            (void) simd::stats(dtype, data, bytes, st);
+            const StreamStatsTLV ss{stream_id, dtype, st.min, st.max, st.sum, st.count, st.nan_count};
+            const TLV tlv{TLV_FRAME_STATS, static_cast<std::uint32_t>(sizeof(ss))};
+            auto* p = fm.payload + fm.used;
+            std::memcpy(p, &tlv, sizeof(TLV));
+            std::memcpy(p + sizeof(TLV), &ss, sizeof(ss));
+            fm.used += STATS_TLV_BYTES;
+            fm.tlv_count += 1u;
+        }
+        static std::uint8_t* reserve_sparse(FrameMap& fm, std::uint32_t stream_id, std::uint32_t nnz, std::uint32_t value_bytes, std::uint32_t dense_count) {
+            constexpr std::uint32_t tlv_head  = sizeof(TLV);
+            constexpr std::uint32_t body_head = sizeof(FrameStreamTLV);
+            const auto body_bytes             = sparse_values_offset(nnz) + nnz * value_bytes;
+            const auto need                   = align_up(tlv_head + body_head + body_bytes, 16);
+            if (fm.used + need > fm.capacity) return nullptr;
+            auto* p = fm.payload + fm.used;
+            TLV tlv{};
+            tlv.type   = TLV_FRAME_SPARSE;
+            tlv.length = body_head + body_bytes;
+            std::memcpy(p, &tlv, sizeof(TLV));
+            FrameStreamTLV fs{};
+            fs.stream_id     = stream_id;
+            fs.elem_count    = nnz;
+            fs.bytes_payload = body_bytes;
+            fs.reserved      = 0u;
+            std::memcpy(p + tlv_head, &fs, sizeof(FrameStreamTLV));
+            SparseHeader sh{};
+            sh.dense_count = dense_count;
+            sh.value_bytes = value_bytes;
+            std::memcpy(p + tlv_head + body_head, &sh, sizeof(SparseHeader));
+            fm.used += need;
+            fm.tlv_count += 1u;
+            return p + tlv_head + body_head;
+        }
         static std::uint64_t make_session_id() noexcept {
             const auto now        = std::chrono::high_resolution_clock::now().time_since_epoch().count();
             const std::size_t tid = std::hash<std::thread::id>{}(std::this_thread::get_id());
@@ -302,10 +835,115 @@ namespace shmx {
             const auto mix        = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(&local) ^ static_cast<std::uintptr_t>(tid));
             return static_cast<std::uint64_t>(now) ^ (mix * 0x9E3779B97F4A7C15ull);
         }
+        std::uint8_t* control_ring(std::uint32_t i) const noexcept {
+            return map_.data() + hdr_->control_offset + i * hdr_->control_stride;
+        }
+        std::uint32_t drain_rpc(std::vector<ControlMsg>& other, std::uint32_t max_msgs) {
+            std::uint32_t served = 0;
+            for (std::uint32_t i = 0; i < hdr_->reader_slots && max_msgs > 0u; ++i) {
+                auto* RS     = reinterpret_cast<ReaderSlot*>(map_.data() + readers_off_ + i * hdr_->reader_slot_stride);
+                bool replied = false;
+                (void) ring_drain(control_ring(i), hdr_->control_per_reader, max_msgs, [&](std::uint32_t type, const std::uint8_t* body, std::uint32_t len) {
+                    if (type != TLV_RPC_REQUEST || len < sizeof(RpcHeader)) {
+                        other.push_back(ControlMsg{reader_id_of(i), type, std::vector<std::uint8_t>(body, body + len)});
+                        return;
+                    }
+                    RpcHeader rh{};
+                    std::memcpy(&rh, body, sizeof(rh));
+                    const RpcRequest req{reader_id_of(i), rh.call_id, rh.method, std::span<const std::uint8_t>(body + sizeof(rh), len - sizeof(rh))};
+                    rpc_buf_.resize(sizeof(RpcHeader));
+                    const auto it = rpc_handlers_.find(rh.method);
+                    rh.status     = it == rpc_handlers_.end() ? RPC_NO_METHOD : it->second(req, rpc_resp_);
+                    if (it == rpc_handlers_.end() || rh.status != RPC_OK) rpc_resp_.clear();
+                    std::memcpy(rpc_buf_.data(), &rh, sizeof(rh));
+                    rpc_buf_.insert(rpc_buf_.end(), rpc_resp_.begin(), rpc_resp_.end());
+                    rpc_resp_.clear();
+                    ++served;
+                    if (hdr_->reply_per_reader == 0u) return;
+                    auto* ring = map_.data() + hdr_->reply_offset + i * hdr_->reply_stride;
+                    if (ring_push(ring, hdr_->reply_per_reader, TLV_RPC_REPLY, rpc_buf_.data(), static_cast<std::uint32_t>(rpc_buf_.size())))
+                        replied = true;
+                    else
+                        SHMX_PROBE2(rpc_reply_drop, i, rh.call_id);
+                });
+                if (replied) doorbell_ring(RS->reply_bell);
+            }
+            return served;
+        }
+        KvEntry* kv_entry(std::uint32_t cls, std::uint32_t i) const noexcept {
+            return reinterpret_cast<KvEntry*>(map_.data() + kv_class_offset(*hdr_, cls) + static_cast<std::size_t>(i) * kv_entry_stride(cls));
+        }
+        KvEntry* kv_find(std::uint32_t cls, std::string_view key, std::uint64_t h) const noexcept {
+            const auto n = hdr_->kv_entries[cls];
+            for (std::uint32_t k = 0, i = static_cast<std::uint32_t>(h) & (n - 1u); k < n; ++k, i = (i + 1u) & (n - 1u)) {
+                auto* e = kv_entry(cls, i);
+                if (e->state == KV_EMPTY) return nullptr;
+                if (e->state == KV_LIVE && e->key_hash == h && std::string_view(e->key, e->key_len) == key) return e;
+            }
+            return nullptr;
+        }
+        KvEntry* kv_free_slot(std::uint32_t cls, std::uint64_t h) const noexcept {
+            const auto n = hdr_->kv_entries[cls];
+            for (std::uint32_t k = 0, i = static_cast<std::uint32_t>(h) & (n - 1u); k < n; ++k, i = (i + 1u) & (n - 1u)) {
+                auto* e = kv_entry(cls, i);
+                if (e->state != KV_LIVE) return e;
+            }
+            return nullptr;
+        }
+        static void kv_write(KvEntry* e, std::uint32_t state, std::string_view key, std::uint64_t h, const void* data, std::uint32_t bytes) noexcept {
+            const auto s = e->seq.load(std::memory_order_relaxed);
+            e->seq.store(s + 1u, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            e->state = state;
+            if (state == KV_LIVE) {
+                e->key_hash  = h;
+                e->key_len   = static_cast<std::uint32_t>(key.size());
+                e->value_len = bytes;
+                std::memcpy(e->key, key.data(), key.size());
+                if (bytes) std::memcpy(reinterpret_cast<std::uint8_t*>(e) + sizeof(KvEntry), data, bytes);
+            }
+            e->seq.store(s + 2u, std::memory_order_release);
+        }
+        static void append_static_tlv(std::vector<std::uint8_t>& out, std::uint32_t type, const void* body, std::uint32_t body_len) {
+            const auto at = out.size();
+            out.resize(at + align_up(static_cast<std::uint32_t>(sizeof(TLV)) + body_len, 16), 0u);
+            TLV tlv{};
+            tlv.type   = type;
+            tlv.length = body_len;
+            std::memcpy(out.data() + at, &tlv, sizeof(TLV));
+            std::memcpy(out.data() + at + sizeof(TLV), body, body_len);
+        }
+        static bool append_shape_tlv(std::vector<std::uint8_t>& out, std::uint32_t stream_id, const std::vector<std::uint64_t>& shape, const std::vector<std::uint64_t>& strides) {
+            if (shape.empty() || shape.size() > MAX_TENSOR_DIMS) return false;
+            if (!strides.empty() && strides.size() != shape.size()) return false;
+            StaticShapeDesc sd{};
+            sd.stream_id = stream_id;
+            sd.ndim      = static_cast<std::uint32_t>(shape.size());
+            for (std::size_t i = shape.size(); i-- > 0;) {
+                sd.extents[i] = shape[i];
+                sd.strides[i] = strides.empty() ? (i + 1 == shape.size() ? 1u : sd.strides[i + 1] * shape[i + 1]) : strides[i];
+            }
+            append_static_tlv(out, TLV_STATIC_SHAPE, &sd, static_cast<std::uint32_t>(sizeof(sd)));
+            return true;
+        }
+        static void append_fields_tlv(std::vector<std::uint8_t>& out, std::uint32_t stream_id, const std::vector<StructField>& fields) {
+            std::vector<std::uint8_t> body(sizeof(StaticFieldsHeader));
+            const StaticFieldsHeader fh{stream_id, static_cast<std::uint32_t>(fields.size())};
+            std::memcpy(body.data(), &fh, sizeof(fh));
+            for (const auto& [name, dtype, offset, count] : fields) {
+                const StaticFieldDesc fd{dtype, count, offset, static_cast<std::uint32_t>(name.size())};
+                const auto at = body.size();
+                body.resize(at + sizeof(fd) + align_up(fd.name_len, 4), 0u);
+                std::memcpy(body.data() + at, &fd, sizeof(fd));
+                std::memcpy(body.data() + at + sizeof(fd), name.data(), fd.name_len);
+            }
+            append_static_tlv(out, TLV_STATIC_FIELDS, body.data(), static_cast<std::uint32_t>(body.size()));
+        }
         static std::uint32_t build_static_dir(const std::vector<StaticStream>& streams, std::vector<std::uint8_t>& out) {
             out.clear();
             std::vector<std::uint8_t> tmp;
-            for (const auto& [stream_id, element_type, components, layout, bytes_per_elem, name_utf8, extra] : streams) {
+            std::uint32_t lod_bit = 0;
+            for (const auto& [stream_id, element_type, components, layout, bytes_per_elem, name_utf8, extra, kind, shape, strides, fields, lod_op, lod_source, lod_factor] : streams) {
                 const auto name_len  = static_cast<std::uint32_t>(name_utf8.size());
                 const auto extra_len = static_cast<std::uint32_t>(extra.size());
                 const auto body_len  = static_cast<std::uint32_t>(sizeof(StaticStreamDesc)) + name_len + extra_len;
@@ -321,13 +959,19 @@ namespace shmx {
                 ss.components     = components;
                 ss.layout         = layout;
                 ss.bytes_per_elem = bytes_per_elem;
-                ss.reserved       = 0u;
+                ss.kind           = kind;
                 ss.name_len       = name_len;
                 ss.extra_len      = extra_len;
                 std::memcpy(p + sizeof(TLV), &ss, sizeof(StaticStreamDesc));
                 std::memcpy(p + sizeof(TLV) + sizeof(StaticStreamDesc), name_utf8.data(), name_len);
                 if (extra_len) std::memcpy(p + sizeof(TLV) + sizeof(StaticStreamDesc) + name_len, extra.data(), extra_len);
                 out.insert(out.end(), tmp.begin(), tmp.end());
+                if (!shape.empty()) (void) append_shape_tlv(out, stream_id, shape, strides);
+                if (!fields.empty()) append_fields_tlv(out, stream_id, fields);
+                if (lod_op != LOD_NONE) {
+                    const StaticLodDesc ld{stream_id, lod_source, lod_op, lod_factor, lod_bit++, 0u};
+                    append_static_tlv(out, TLV_STATIC_LOD, &ld, static_cast<std::uint32_t>(sizeof(ld)));
+                }
             }
             return static_cast<std::uint32_t>(out.size());
         }
@@ -341,6 +985,21 @@ namespace shmx {
         std::uint32_t slots_off_ = 0, readers_off_ = 0;
         std::vector<std::uint8_t> static_dir_;
         std::uint64_t session_id_ = 0;
+        std::unordered_map<std::uint32_t, RpcHandler> rpc_handlers_;
+        std::vector<std::uint8_t> rpc_buf_, rpc_resp_;
+        std::unordered_map<std::uint32_t, std::uint32_t> stats_dtypes_;
+        std::vector<LodPlan> lods_;
+        struct SeenStream {
+            std::uint64_t hash, frame_id;
+        };
+        struct FreshStream {
+            std::uint32_t stream_id;
+            std::uint64_t hash;
+        };
+        bool suppress_duplicates_ = false;
+        mutable std::unordered_map<std::uint32_t, SeenStream> seen_;
+        mutable std::vector<FreshStream> fresh_;
+        mutable std::uint32_t seen_streams_ = 0, same_streams_ = 0, reuse_seq_ = 0;
     };
 } // namespace shmx
 #endif // SHMX_SERVER_H
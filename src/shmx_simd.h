@@ -0,0 +1,460 @@
+#ifndef SHMX_SIMD_H
+#define SHMX_SIMD_H
+#include "shmx_common.h"
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace shmx::simd {
+
+    inline void gather(void* dst, const void* src, const std::uint32_t* idx, std::uint32_t n, std::uint32_t value_bytes) noexcept {
+        auto* d       = static_cast<std::uint8_t*>(dst);
+        const auto* s = static_cast<const std::uint8_t*>(src);
+        std::uint32_t i = 0;
+#if defined(__AVX2__)
+        if (value_bytes == 4u) {
+            for (; i + 8u <= n; i += 8u) {
+                const __m256i vi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(idx + i));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + i * 4u), _mm256_i32gather_epi32(reinterpret_cast<const int*>(s), vi, 4));
+            }
+        } else if (value_bytes == 8u) {
+            for (; i + 4u <= n; i += 4u) {
+                const __m128i vi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(idx + i));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + i * 8u), _mm256_i32gather_epi64(reinterpret_cast<const long long*>(s), vi, 8));
+            }
+        }
+#endif
+        for (; i < n; ++i) std::memcpy(d + static_cast<std::size_t>(i) * value_bytes, s + static_cast<std::size_t>(idx[i]) * value_bytes, value_bytes);
+    }
+
+    inline void scatter(void* dst, const void* src, const std::uint32_t* idx, std::uint32_t n, std::uint32_t value_bytes) noexcept {
+        auto* d       = static_cast<std::uint8_t*>(dst);
+        const auto* s = static_cast<const std::uint8_t*>(src);
+        std::uint32_t i = 0;
+#if defined(__AVX512F__)
+        if (value_bytes == 4u) {
+            for (; i + 16u <= n; i += 16u) {
+                const __m512i vi = _mm512_loadu_si512(idx + i);
+                _mm512_i32scatter_epi32(d, vi, _mm512_loadu_si512(s + i * 4u), 4);
+            }
+        } else if (value_bytes == 8u) {
+            for (; i + 8u <= n; i += 8u) {
+                const __m256i vi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(idx + i));
+                _mm512_i32scatter_epi64(d, vi, _mm512_loadu_si512(s + i * 8u), 8);
+            }
+        }
+#endif
+        for (; i < n; ++i) std::memcpy(d + static_cast<std::size_t>(idx[i]) * value_bytes, s + static_cast<std::size_t>(i) * value_bytes, value_bytes);
+    }
+
+    inline void gather_strided(void* dst, const void* src, std::size_t stride, std::uint32_t n, std::uint32_t value_bytes) noexcept {
+        auto* d       = static_cast<std::uint8_t*>(dst);
+        const auto* s = static_cast<const std::uint8_t*>(src);
+        std::uint32_t i = 0;
+#if defined(__AVX2__)
+        if (stride <= 0x0FFFFFFFu) {
+            const auto st = static_cast<int>(stride);
+            if (value_bytes == 4u) {
+                const __m256i vo = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(st));
+                for (; i + 8u <= n; i += 8u) _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + i * 4u), _mm256_i32gather_epi32(reinterpret_cast<const int*>(s + i * stride), vo, 1));
+            } else if (value_bytes == 8u) {
+                const __m128i vo = _mm_mullo_epi32(_mm_setr_epi32(0, 1, 2, 3), _mm_set1_epi32(st));
+                for (; i + 4u <= n; i += 4u) _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + i * 8u), _mm256_i32gather_epi64(reinterpret_cast<const long long*>(s + i * stride), vo, 1));
+            }
+        }
+#endif
+        for (; i < n; ++i) std::memcpy(d + static_cast<std::size_t>(i) * value_bytes, s + i * stride, value_bytes);
+    }
+
+    inline std::uint32_t max_index(const std::uint32_t* idx, std::uint32_t n) noexcept {
+        std::uint32_t m = 0, i = 0;
+#if defined(__AVX2__)
+        __m256i vm = _mm256_setzero_si256();
+        for (; i + 8u <= n; i += 8u) vm = _mm256_max_epu32(vm, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(idx + i)));
+        alignas(32) std::uint32_t lanes[8];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), vm);
+        for (const auto v : lanes) m = v > m ? v : m;
+#endif
+        for (; i < n; ++i) m = idx[i] > m ? idx[i] : m;
+        return m;
+    }
+
+    inline std::uint64_t hash64(const void* data, std::size_t n) noexcept {
+        constexpr std::uint64_t k = 0x9E3779B97F4A7C15ull;
+        const auto* p             = static_cast<const std::uint8_t*>(data);
+        std::uint64_t h[4]        = {k, k + 1u, k + 2u, k + 3u};
+        std::uint64_t w           = 0;
+        std::size_t i             = 0;
+        for (; i + 32u <= n; i += 32u) {
+            for (std::size_t l = 0; l < 4u; ++l) {
+                std::memcpy(&w, p + i + 8u * l, sizeof(w));
+                h[l] = std::rotl(h[l] ^ w, 29) * k;
+            }
+        }
+        std::uint64_t r = static_cast<std::uint64_t>(n) * k;
+        for (const auto x : h) r = std::rotl(r ^ x, 29) * k;
+        for (; i + 8u <= n; i += 8u) {
+            std::memcpy(&w, p + i, sizeof(w));
+            r = std::rotl(r ^ w, 29) * k;
+        }
+        for (; i < n; ++i) r = (r ^ p[i]) * 1099511628211ull;
+        r ^= r >> 33;
+        r *= 0xFF51AFD7ED558CCDull;
+        return r ^ (r >> 33);
+    }
+
+    inline void lerp(float* out, const float* a, const float* b, std::size_t n, float t) noexcept {
+        std::size_t i = 0;
+#if defined(__AVX512F__)
+        const __m512 vt = _mm512_set1_ps(t);
+        for (; i + 16u <= n; i += 16u) {
+            const __m512 va = _mm512_loadu_ps(a + i);
+            _mm512_storeu_ps(out + i, _mm512_fmadd_ps(_mm512_sub_ps(_mm512_loadu_ps(b + i), va), vt, va));
+        }
+#elif defined(__AVX2__)
+        const __m256 vt = _mm256_set1_ps(t);
+        for (; i + 8u <= n; i += 8u) {
+            const __m256 va = _mm256_loadu_ps(a + i);
+            const __m256 vd = _mm256_sub_ps(_mm256_loadu_ps(b + i), va);
+#if defined(__FMA__)
+            _mm256_storeu_ps(out + i, _mm256_fmadd_ps(vd, vt, va));
+#else
+            _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_mul_ps(vd, vt), va));
+#endif
+        }
+#endif
+        for (; i < n; ++i) out[i] = a[i] + (b[i] - a[i]) * t;
+    }
+
+    inline void lerp(double* out, const double* a, const double* b, std::size_t n, double t) noexcept {
+        std::size_t i = 0;
+#if defined(__AVX512F__)
+        const __m512d vt = _mm512_set1_pd(t);
+        for (; i + 8u <= n; i += 8u) {
+            const __m512d va = _mm512_loadu_pd(a + i);
+            _mm512_storeu_pd(out + i, _mm512_fmadd_pd(_mm512_sub_pd(_mm512_loadu_pd(b + i), va), vt, va));
+        }
+#elif defined(__AVX2__)
+        const __m256d vt = _mm256_set1_pd(t);
+        for (; i + 4u <= n; i += 4u) {
+            const __m256d va = _mm256_loadu_pd(a + i);
+            const __m256d vd = _mm256_sub_pd(_mm256_loadu_pd(b + i), va);
+#if defined(__FMA__)
+            _mm256_storeu_pd(out + i, _mm256_fmadd_pd(vd, vt, va));
+#else
+            _mm256_storeu_pd(out + i, _mm256_add_pd(_mm256_mul_pd(vd, vt), va));
+#endif
+        }
+#endif
+        for (; i < n; ++i) out[i] = a[i] + (b[i] - a[i]) * t;
+    }
+
+    struct ValueStats {
+        double min              = std::numeric_limits<double>::infinity();
+        double max              = -std::numeric_limits<double>::infinity();
+        double sum              = 0.0;
+        std::uint64_t count     = 0;
+        std::uint64_t nan_count = 0;
+
+        void merge(const ValueStats& o) noexcept {
+            min = o.min < min ? o.min : min;
+            max = o.max > max ? o.max : max;
+            sum += o.sum;
+            count += o.count;
+            nan_count += o.nan_count;
+        }
+    };
+
+    enum class CmpOp : std::uint32_t { Gt, Ge, Lt, Le, Eq, Ne };
+
+    template <class T>
+    inline void accumulate(const T* p, std::size_t n, ValueStats& st) noexcept {
+        std::size_t i = 0;
+#if defined(__AVX2__)
+        if constexpr (std::is_same_v<T, float>) {
+            const __m256 pinf = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+            const __m256 ninf = _mm256_set1_ps(-std::numeric_limits<float>::infinity());
+            __m256 vmn = pinf, vmx = ninf;
+            __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+            std::uint64_t nan = 0;
+            for (; i + 8u <= n; i += 8u) {
+                const __m256 v   = _mm256_loadu_ps(p + i);
+                const __m256 ord = _mm256_cmp_ps(v, v, _CMP_ORD_Q);
+                nan += 8u - static_cast<std::uint32_t>(std::popcount(static_cast<std::uint32_t>(_mm256_movemask_ps(ord))));
+                vmn             = _mm256_min_ps(vmn, _mm256_blendv_ps(pinf, v, ord));
+                vmx             = _mm256_max_ps(vmx, _mm256_blendv_ps(ninf, v, ord));
+                const __m256 z  = _mm256_and_ps(v, ord);
+                s0              = _mm256_add_pd(s0, _mm256_cvtps_pd(_mm256_castps256_ps128(z)));
+                s1              = _mm256_add_pd(s1, _mm256_cvtps_pd(_mm256_extractf128_ps(z, 1)));
+            }
+            alignas(32) float mn[8], mx[8];
+            alignas(32) double sm[4];
+            _mm256_store_ps(mn, vmn);
+            _mm256_store_ps(mx, vmx);
+            _mm256_store_pd(sm, _mm256_add_pd(s0, s1));
+            for (int j = 0; j < 8; ++j) {
+                st.min = mn[j] < st.min ? mn[j] : st.min;
+                st.max = mx[j] > st.max ? mx[j] : st.max;
+            }
+            st.sum += sm[0] + sm[1] + sm[2] + sm[3];
+            st.count += i - nan;
+            st.nan_count += nan;
+        } else if constexpr (std::is_same_v<T, double>) {
+            const __m256d pinf = _mm256_set1_pd(std::numeric_limits<double>::infinity());
+            const __m256d ninf = _mm256_set1_pd(-std::numeric_limits<double>::infinity());
+            __m256d vmn = pinf, vmx = ninf, s0 = _mm256_setzero_pd();
+            std::uint64_t nan = 0;
+            for (; i + 4u <= n; i += 4u) {
+                const __m256d v   = _mm256_loadu_pd(p + i);
+                const __m256d ord = _mm256_cmp_pd(v, v, _CMP_ORD_Q);
+                nan += 4u - static_cast<std::uint32_t>(std::popcount(static_cast<std::uint32_t>(_mm256_movemask_pd(ord))));
+                vmn = _mm256_min_pd(vmn, _mm256_blendv_pd(pinf, v, ord));
+                vmx = _mm256_max_pd(vmx, _mm256_blendv_pd(ninf, v, ord));
+                s0  = _mm256_add_pd(s0, _mm256_and_pd(v, ord));
+            }
+            alignas(32) double mn[4], mx[4], sm[4];
+            _mm256_store_pd(mn, vmn);
+            _mm256_store_pd(mx, vmx);
+            _mm256_store_pd(sm, s0);
+            for (int j = 0; j < 4; ++j) {
+                st.min = mn[j] < st.min ? mn[j] : st.min;
+                st.max = mx[j] > st.max ? mx[j] : st.max;
+            }
+            st.sum += sm[0] + sm[1] + sm[2] + sm[3];
+            st.count += i - nan;
+            st.nan_count += nan;
+        }
+#endif
+        constexpr std::size_t L = 8;
+        T mn[L], mx[L];
+        double sm[L]          = {};
+        std::uint64_t nan[L]  = {};
+        for (std::size_t j = 0; j < L; ++j) {
+            mn[j] = std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+            mx[j] = std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::lowest();
+        }
+        const auto lane = [&](std::size_t j, T v) {
+            if constexpr (std::is_floating_point_v<T>) {
+                const bool ok = v == v;
+                nan[j] += ok ? 0u : 1u;
+                mn[j] = ok && v < mn[j] ? v : mn[j];
+                mx[j] = ok && v > mx[j] ? v : mx[j];
+                sm[j] += ok ? static_cast<double>(v) : 0.0;
+            } else {
+                mn[j] = v < mn[j] ? v : mn[j];
+                mx[j] = v > mx[j] ? v : mx[j];
+                sm[j] += static_cast<double>(v);
+            }
+        };
+        const auto start = i;
+        for (; i + L <= n; i += L)
+            for (std::size_t j = 0; j < L; ++j) lane(j, p[i + j]);
+        for (; i < n; ++i) lane(0, p[i]);
+        std::uint64_t nans = 0;
+        for (std::size_t j = 0; j < L; ++j) {
+            nans += nan[j];
+            st.sum += sm[j];
+            if (static_cast<double>(mn[j]) < st.min) st.min = static_cast<double>(mn[j]);
+            if (static_cast<double>(mx[j]) > st.max) st.max = static_cast<double>(mx[j]);
+        }
+        st.count += n - start - nans;
+        st.nan_count += nans;
+    }
+
+    template <class T>
+    inline void compare(const T* p, std::size_t n, CmpOp op, double y, std::uint8_t* out) noexcept {
+        switch (op) {
+        case CmpOp::Gt:
+            for (std::size_t i = 0; i < n; ++i) out[i] = static_cast<double>(p[i]) > y;
+            break;
+        case CmpOp::Ge:
+            for (std::size_t i = 0; i < n; ++i) out[i] = static_cast<double>(p[i]) >= y;
+            break;
+        case CmpOp::Lt:
+            for (std::size_t i = 0; i < n; ++i) out[i] = static_cast<double>(p[i]) < y;
+            break;
+        case CmpOp::Le:
+            for (std::size_t i = 0; i < n; ++i) out[i] = static_cast<double>(p[i]) <= y;
+            break;
+        case CmpOp::Eq:
+            for (std::size_t i = 0; i < n; ++i) out[i] = static_cast<double>(p[i]) == y;
+            break;
+        case CmpOp::Ne:
+            for (std::size_t i = 0; i < n; ++i) out[i] = static_cast<double>(p[i]) != y;
+            break;
+        }
+    }
+
+    template <class F>
+    inline bool visit_numeric(std::uint32_t dtype, F&& f) {
+        switch (dtype) {
+        case DT_BOOL:
+        case DT_U8: f(std::uint8_t{}); return true;
+        case DT_I8: f(std::int8_t{}); return true;
+        case DT_I16: f(std::int16_t{}); return true;
+        case DT_U16: f(std::uint16_t{}); return true;
+        case DT_I32: f(std::int32_t{}); return true;
+        case DT_U32: f(std::uint32_t{}); return true;
+        case DT_I64: f(std::int64_t{}); return true;
+        case DT_U64: f(std::uint64_t{}); return true;
+        case DT_F32: f(float{}); return true;
+        case DT_F64: f(double{}); return true;
+        default: return false;
+        }
+    }
+
+    inline bool stats(std::uint32_t dtype, const void* data, std::size_t bytes, ValueStats& st) noexcept {
+        return visit_numeric(dtype, [&](auto tag) {
+            using T = decltype(tag);
+            accumulate(static_cast<const T*>(data), bytes / sizeof(T), st);
+        });
+    }
+
+    inline bool compare(std::uint32_t dtype, const void* data, std::size_t n, CmpOp op, double y, std::uint8_t* out) noexcept {
+        return visit_numeric(dtype, [&](auto tag) {
+            using T = decltype(tag);
+            compare(static_cast<const T*>(data), n, op, y, out);
+        });
+    }
+
+    template <class T, class Acc>
+    inline Acc row_sum(const T* x, std::size_t m) noexcept {
+        Acc s         = 0;
+        std::size_t i = 0;
+#if defined(__AVX2__)
+        if constexpr (std::is_same_v<T, float>) {
+            __m256 acc = _mm256_setzero_ps();
+            for (; i + 8u <= m; i += 8u) acc = _mm256_add_ps(acc, _mm256_loadu_ps(x + i));
+            alignas(32) float lanes[8];
+            _mm256_store_ps(lanes, acc);
+            for (const auto v : lanes) s += v;
+        }
+#endif
+        Acc lanes[8] = {};
+        for (; i + 8u <= m; i += 8u)
+            for (std::size_t l = 0; l < 8u; ++l) lanes[l] += static_cast<Acc>(x[i + l]);
+        for (const auto v : lanes) s += v;
+        for (; i < m; ++i) s += static_cast<Acc>(x[i]);
+        return s;
+    }
+
+    template <class T>
+    inline void row_minmax(const T* x, std::size_t m, T& lo, T& hi) noexcept {
+        lo            = x[0];
+        hi            = x[0];
+        std::size_t i = 0;
+#if defined(__AVX2__)
+        if constexpr (std::is_same_v<T, float>) {
+            if (m >= 8u) {
+                __m256 vlo = _mm256_loadu_ps(x), vhi = vlo;
+                for (i = 8u; i + 8u <= m; i += 8u) {
+                    const __m256 v = _mm256_loadu_ps(x + i);
+                    vlo            = _mm256_min_ps(vlo, v);
+                    vhi            = _mm256_max_ps(vhi, v);
+                }
+                alignas(32) float l[8], h[8];
+                _mm256_store_ps(l, vlo);
+                _mm256_store_ps(h, vhi);
+                for (std::size_t k = 0; k < 8u; ++k) {
+                    lo = l[k] < lo ? l[k] : lo;
+                    hi = h[k] > hi ? h[k] : hi;
+                }
+            }
+        }
+#endif
+        if (i == 0u && m >= 8u) {
+            T l[8], h[8];
+            for (std::size_t k = 0; k < 8u; ++k) l[k] = h[k] = x[k];
+            for (i = 8u; i + 8u <= m; i += 8u) {
+                for (std::size_t k = 0; k < 8u; ++k) {
+                    l[k] = x[i + k] < l[k] ? x[i + k] : l[k];
+                    h[k] = x[i + k] > h[k] ? x[i + k] : h[k];
+                }
+            }
+            for (std::size_t k = 0; k < 8u; ++k) {
+                lo = l[k] < lo ? l[k] : lo;
+                hi = h[k] > hi ? h[k] : hi;
+            }
+        }
+        for (; i < m; ++i) {
+            lo = x[i] < lo ? x[i] : lo;
+            hi = x[i] > hi ? x[i] : hi;
+        }
+    }
+
+    template <class T>
+    inline T round_to(double v) noexcept {
+        if constexpr (std::is_floating_point_v<T>)
+            return static_cast<T>(v);
+        else
+            return static_cast<T>(v < 0.0 ? v - 0.5 : v + 0.5);
+    }
+
+    template <class T>
+    inline void block_mean(T* out, const T* in, std::size_t n, std::uint32_t comps, std::uint32_t factor) noexcept {
+        using Acc                = std::conditional_t<std::is_same_v<T, float>, float, double>;
+        const std::size_t blocks = (n + factor - 1u) / factor;
+        for (std::size_t b = 0; b < blocks; ++b) {
+            const T* x   = in + b * factor * comps;
+            const auto m = std::min<std::size_t>(factor, n - b * factor);
+            T* o         = out + b * comps;
+            if (comps == 1u) {
+                o[0] = round_to<T>(static_cast<double>(row_sum<T, Acc>(x, m)) / static_cast<double>(m));
+                continue;
+            }
+            for (std::uint32_t k0 = 0; k0 < comps; k0 += 64u) {
+                const auto kc = std::min(comps - k0, 64u);
+                Acc acc[64]   = {};
+                for (std::size_t j = 0; j < m; ++j)
+                    for (std::uint32_t k = 0; k < kc; ++k) acc[k] += static_cast<Acc>(x[j * comps + k0 + k]);
+                for (std::uint32_t k = 0; k < kc; ++k) o[k0 + k] = round_to<T>(static_cast<double>(acc[k]) / static_cast<double>(m));
+            }
+        }
+    }
+
+    template <class T>
+    inline void block_minmax(T* out, const T* in, std::size_t n, std::uint32_t comps, std::uint32_t factor) noexcept {
+        const std::size_t blocks = (n + factor - 1u) / factor;
+        for (std::size_t b = 0; b < blocks; ++b) {
+            const T* x   = in + b * factor * comps;
+            const auto m = std::min<std::size_t>(factor, n - b * factor);
+            T* o         = out + b * comps * 2u;
+            if (comps == 1u) {
+                row_minmax(x, m, o[0], o[1]);
+                continue;
+            }
+            for (std::uint32_t k = 0; k < comps; ++k) o[k] = o[comps + k] = x[k];
+            for (std::size_t j = 1; j < m; ++j) {
+                for (std::uint32_t k = 0; k < comps; ++k) {
+                    const T v    = x[j * comps + k];
+                    o[k]         = v < o[k] ? v : o[k];
+                    o[comps + k] = v > o[comps + k] ? v : o[comps + k];
+                }
+            }
+        }
+    }
+
+    inline bool downsample(std::uint32_t op, std::uint32_t dtype, void* out, const void* in, std::size_t n, std::uint32_t comps, std::uint32_t bytes_per_elem, std::uint32_t factor) noexcept {
+        if (factor == 0u || n == 0u) return false;
+        if (op == LOD_STRIDE) {
+            gather_strided(out, in, static_cast<std::size_t>(factor) * bytes_per_elem, static_cast<std::uint32_t>((n + factor - 1u) / factor), bytes_per_elem);
+            return true;
+        }
+        return visit_numeric(dtype, [&](auto tag) {
+            using T = decltype(tag);
+            if (op == LOD_MEAN)
+                block_mean(static_cast<T*>(out), static_cast<const T*>(in), n, comps, factor);
+            else
+                block_minmax(static_cast<T*>(out), static_cast<const T*>(in), n, comps, factor);
+        });
+    }
+
+} // namespace shmx::simd
+#endif // SHMX_SIMD_H
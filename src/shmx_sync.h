@@ -0,0 +1,303 @@
+#ifndef SHMX_SYNC_H
+#define SHMX_SYNC_H
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <csignal>
+#include <ctime>
+#include <unistd.h>
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+#endif
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+namespace shmx {
+
+    using SyncClock = std::chrono::steady_clock;
+
+    inline constexpr std::uint32_t SYNC_CELL_BYTES = 64;
+    inline constexpr std::uint32_t MUTEX_WAITERS   = 0x80000000u;
+
+    inline constexpr std::uint32_t LOCK_OK        = 0;
+    inline constexpr std::uint32_t LOCK_RECOVERED = 1;
+    inline constexpr std::uint32_t LOCK_TIMEOUT   = 2;
+    inline constexpr std::uint32_t WAIT_TIMED_OUT = 4;
+
+    inline constexpr std::uint32_t BARRIER_OK      = 0;
+    inline constexpr std::uint32_t BARRIER_SERIAL  = 1;
+    inline constexpr std::uint32_t BARRIER_TIMEOUT = 2;
+    inline constexpr std::uint32_t BARRIER_ROUND   = 1u << 24;
+
+    inline constexpr std::uint32_t FUTEX_WAITV_LIMIT = 128;
+    inline constexpr int WAIT_ANY_TIMEOUT            = -1;
+    inline constexpr int WAIT_ANY_UNSUPPORTED        = -2;
+
+    inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+        _mm_pause();
+#elif defined(__aarch64__)
+        __asm__ __volatile__("yield");
+#endif
+    }
+
+    inline SyncClock::time_point deadline_after(std::uint64_t timeout_ns) noexcept {
+        const auto now = SyncClock::now();
+        if (timeout_ns >= static_cast<std::uint64_t>((SyncClock::time_point::max() - now).count())) return SyncClock::time_point::max();
+        return now + std::chrono::nanoseconds(timeout_ns);
+    }
+
+    inline std::uint32_t current_pid() noexcept {
+#if defined(_WIN32)
+        return static_cast<std::uint32_t>(::GetCurrentProcessId());
+#else
+        return static_cast<std::uint32_t>(::getpid());
+#endif
+    }
+
+    inline bool pid_alive(std::uint32_t pid) noexcept {
+#if defined(_WIN32)
+        HANDLE h = ::OpenProcess(SYNCHRONIZE, FALSE, static_cast<DWORD>(pid));
+        if (!h) return ::GetLastError() == ERROR_ACCESS_DENIED;
+        const bool alive = ::WaitForSingleObject(h, 0) == WAIT_TIMEOUT;
+        ::CloseHandle(h);
+        return alive;
+#else
+        return ::kill(static_cast<pid_t>(pid), 0) == 0 || errno != ESRCH;
+#endif
+    }
+
+    inline void futex_wake(std::atomic<std::uint32_t>* addr, std::uint32_t count) noexcept {
+#if defined(__linux__)
+        ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(addr), FUTEX_WAKE, static_cast<int>(count > 0x7FFFFFFFu ? 0x7FFFFFFFu : count), nullptr, nullptr, 0);
+#else
+        (void) addr;
+        (void) count;
+#endif
+    }
+
+    inline void futex_wait(std::atomic<std::uint32_t>* addr, std::uint32_t expected, std::uint64_t timeout_ns) noexcept {
+#if defined(__linux__)
+        timespec ts{};
+        ts.tv_sec  = static_cast<time_t>(timeout_ns / 1000000000ull);
+        ts.tv_nsec = static_cast<long>(timeout_ns % 1000000000ull);
+        ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(addr), FUTEX_WAIT, expected, &ts, nullptr, 0);
+#else
+        if (addr->load(std::memory_order_acquire) == expected) std::this_thread::sleep_for(std::chrono::nanoseconds(timeout_ns < 50000u ? timeout_ns : 50000u));
+#endif
+    }
+
+    inline int futex_wait_any(std::atomic<std::uint32_t>* const* words, const std::uint32_t* expected, std::uint32_t n, SyncClock::time_point deadline) noexcept {
+#if defined(__linux__) && defined(__NR_futex_waitv) && defined(FUTEX_32)
+        if (n == 0u || n > FUTEX_WAITV_LIMIT) return WAIT_ANY_UNSUPPORTED;
+        futex_waitv v[FUTEX_WAITV_LIMIT]{};
+        for (std::uint32_t i = 0; i < n; ++i) {
+            v[i].val   = expected[i];
+            v[i].uaddr = reinterpret_cast<std::uintptr_t>(words[i]);
+            v[i].flags = FUTEX_32;
+        }
+        timespec ts{};
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+        ts.tv_sec     = static_cast<time_t>(ns / 1000000000);
+        ts.tv_nsec    = static_cast<long>(ns % 1000000000);
+        const long r  = ::syscall(__NR_futex_waitv, v, n, 0, deadline == SyncClock::time_point::max() ? nullptr : &ts, CLOCK_MONOTONIC);
+        if (r >= 0) return static_cast<int>(r);
+        return errno == ENOSYS ? WAIT_ANY_UNSUPPORTED : WAIT_ANY_TIMEOUT;
+#else
+        (void) words;
+        (void) expected;
+        (void) n;
+        (void) deadline;
+        return WAIT_ANY_UNSUPPORTED;
+#endif
+    }
+
+    class Backoff {
+    public:
+        bool spin() noexcept {
+            if (step_ >= 7u) return false;
+            for (std::uint32_t i = 0; i < (1u << step_); ++i) cpu_relax();
+            ++step_;
+            return true;
+        }
+        void snooze() noexcept {
+            if (!spin()) std::this_thread::yield();
+        }
+        void reset() noexcept {
+            step_ = 0;
+        }
+
+    private:
+        std::uint32_t step_ = 0;
+    };
+
+    inline bool wait_while_equal(std::atomic<std::uint32_t>& word, std::uint32_t seen, std::atomic<std::uint32_t>* waiters, SyncClock::time_point deadline, std::uint64_t max_sleep_ns = UINT64_MAX) noexcept {
+        Backoff backoff;
+        while (word.load(std::memory_order_acquire) == seen) {
+            if (backoff.spin()) continue;
+            const auto now = SyncClock::now();
+            if (now >= deadline) return false;
+            auto left = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now).count());
+            if (left > max_sleep_ns) left = max_sleep_ns;
+            if (waiters) waiters->fetch_add(1u, std::memory_order_seq_cst);
+            if (word.load(std::memory_order_seq_cst) == seen) futex_wait(&word, seen, left);
+            if (waiters) waiters->fetch_sub(1u, std::memory_order_seq_cst);
+            if (max_sleep_ns != UINT64_MAX) return word.load(std::memory_order_acquire) != seen;
+        }
+        return true;
+    }
+
+    struct Doorbell {
+        std::atomic<std::uint32_t> seq;
+        std::atomic<std::uint32_t> waiters;
+    };
+
+    inline void doorbell_ring(Doorbell& d) noexcept {
+        d.seq.fetch_add(1u, std::memory_order_seq_cst);
+        if (d.waiters.load(std::memory_order_seq_cst) != 0u) futex_wake(&d.seq, UINT32_MAX);
+    }
+
+    inline bool doorbell_wait_until(Doorbell& d, std::uint32_t seen, SyncClock::time_point deadline) noexcept {
+        return wait_while_equal(d.seq, seen, &d.waiters, deadline);
+    }
+
+    inline bool doorbell_wait(Doorbell& d, std::uint32_t seen, std::uint64_t timeout_ns) noexcept {
+        return doorbell_wait_until(d, seen, deadline_after(timeout_ns));
+    }
+
+    struct ShmMutex {
+        std::atomic<std::uint32_t> state;
+
+        [[nodiscard]] bool try_lock() noexcept {
+            std::uint32_t cur = 0;
+            return state.compare_exchange_strong(cur, current_pid(), std::memory_order_acquire);
+        }
+
+        std::uint32_t lock(std::uint64_t timeout_ns = UINT64_MAX) noexcept {
+            return lock_until(deadline_after(timeout_ns));
+        }
+
+        std::uint32_t lock_until(SyncClock::time_point deadline) noexcept {
+            const auto me = current_pid();
+            Backoff backoff;
+            bool slept = false;
+            for (;;) {
+                auto cur         = state.load(std::memory_order_relaxed);
+                const auto owner = cur & ~MUTEX_WAITERS;
+                if (owner == 0u) {
+                    if (state.compare_exchange_weak(cur, me | (slept ? MUTEX_WAITERS : 0u), std::memory_order_acquire)) return LOCK_OK;
+                    continue;
+                }
+                if (backoff.spin()) continue;
+                if (owner != me && !pid_alive(owner)) {
+                    if (state.compare_exchange_strong(cur, me | MUTEX_WAITERS, std::memory_order_acquire)) return LOCK_RECOVERED;
+                    continue;
+                }
+                if (!(cur & MUTEX_WAITERS) && !state.compare_exchange_weak(cur, cur | MUTEX_WAITERS, std::memory_order_relaxed)) continue;
+                if (SyncClock::now() >= deadline) return LOCK_TIMEOUT;
+                (void) wait_while_equal(state, cur | MUTEX_WAITERS, nullptr, deadline, 10000000u);
+                slept = true;
+            }
+        }
+
+        void unlock() noexcept {
+            if (state.exchange(0u, std::memory_order_release) & MUTEX_WAITERS) futex_wake(&state, 1u);
+        }
+
+        [[nodiscard]] std::uint32_t owner() const noexcept {
+            return state.load(std::memory_order_acquire) & ~MUTEX_WAITERS;
+        }
+    };
+
+    struct ShmCondVar {
+        std::atomic<std::uint32_t> seq;
+        std::atomic<std::uint32_t> waiters;
+
+        std::uint32_t wait(ShmMutex& m, std::uint64_t timeout_ns = UINT64_MAX) noexcept {
+            const auto seen     = seq.load(std::memory_order_acquire);
+            const auto deadline = deadline_after(timeout_ns);
+            m.unlock();
+            const bool woke = wait_while_equal(seq, seen, &waiters, deadline);
+            const auto r    = m.lock_until(deadline);
+            return r == LOCK_TIMEOUT || woke ? r : r | WAIT_TIMED_OUT;
+        }
+
+        void notify_one() noexcept {
+            seq.fetch_add(1u, std::memory_order_seq_cst);
+            if (waiters.load(std::memory_order_seq_cst) != 0u) futex_wake(&seq, 1u);
+        }
+
+        void notify_all() noexcept {
+            seq.fetch_add(1u, std::memory_order_seq_cst);
+            if (waiters.load(std::memory_order_seq_cst) != 0u) futex_wake(&seq, UINT32_MAX);
+        }
+    };
+
+    struct ShmBarrier {
+        std::atomic<std::uint32_t> generation;
+        std::atomic<std::uint32_t> waiters;
+        std::atomic<std::uint32_t> arrived;
+        std::atomic<std::uint32_t> parties;
+
+        void init(std::uint32_t n) noexcept {
+            arrived.store(0u, std::memory_order_relaxed);
+            parties.store(n, std::memory_order_release);
+        }
+
+        std::uint32_t arrive_and_wait(std::uint64_t timeout_ns = UINT64_MAX) noexcept {
+            const auto gen   = generation.load(std::memory_order_acquire);
+            const auto prior = arrived.fetch_add(1u, std::memory_order_acq_rel);
+            const auto round = prior & ~(BARRIER_ROUND - 1u);
+            if ((prior & (BARRIER_ROUND - 1u)) + 1u == parties.load(std::memory_order_acquire)) {
+                arrived.store(round + BARRIER_ROUND, std::memory_order_relaxed);
+                generation.fetch_add(1u, std::memory_order_seq_cst);
+                if (waiters.load(std::memory_order_seq_cst) != 0u) futex_wake(&generation, UINT32_MAX);
+                return BARRIER_SERIAL;
+            }
+            if (wait_while_equal(generation, gen, &waiters, deadline_after(timeout_ns))) return BARRIER_OK;
+            auto cur = arrived.load(std::memory_order_acquire);
+            while ((cur & ~(BARRIER_ROUND - 1u)) == round)
+                if (arrived.compare_exchange_weak(cur, cur - 1u, std::memory_order_acq_rel)) return BARRIER_TIMEOUT;
+            (void) wait_while_equal(generation, gen, &waiters, SyncClock::time_point::max());
+            return BARRIER_OK;
+        }
+    };
+
+    struct ShmEventCount {
+        std::atomic<std::uint32_t> count;
+        std::atomic<std::uint32_t> waiters;
+
+        [[nodiscard]] std::uint32_t value() const noexcept {
+            return count.load(std::memory_order_acquire);
+        }
+
+        std::uint32_t advance(std::uint32_t n = 1u) noexcept {
+            const auto v = count.fetch_add(n, std::memory_order_seq_cst) + n;
+            if (waiters.load(std::memory_order_seq_cst) != 0u) futex_wake(&count, UINT32_MAX);
+            return v;
+        }
+
+        [[nodiscard]] bool await(std::uint32_t target, std::uint64_t timeout_ns = UINT64_MAX) noexcept {
+            const auto deadline = deadline_after(timeout_ns);
+            for (;;) {
+                const auto cur = count.load(std::memory_order_acquire);
+                if (static_cast<std::int32_t>(cur - target) >= 0) return true;
+                if (!wait_while_equal(count, cur, &waiters, deadline)) return false;
+            }
+        }
+    };
+
+} // namespace shmx
+#endif // SHMX_SYNC_H
@@ -0,0 +1,234 @@
+#ifndef SHMX_TRACE_H
+#define SHMX_TRACE_H
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace shmx {
+
+    inline constexpr std::uint64_t TRACE_MAGIC   = 0x48494E415F545243ull;
+    inline constexpr std::uint32_t TRACE_VERSION = 1;
+
+    inline constexpr std::uint32_t STAGE_BEGIN_FRAME   = 1;
+    inline constexpr std::uint32_t STAGE_APPEND_STREAM = 2;
+    inline constexpr std::uint32_t STAGE_CHECKSUM      = 3;
+    inline constexpr std::uint32_t STAGE_PUBLISH       = 4;
+    inline constexpr std::uint32_t STAGE_READER_WAKE   = 5;
+    inline constexpr std::uint32_t STAGE_VALIDATE      = 6;
+    inline constexpr std::uint32_t STAGE_DECODE        = 7;
+    inline constexpr std::uint32_t STAGE_USER          = 0x100;
+
+    constexpr const char* stage_name(std::uint32_t stage) noexcept {
+        switch (stage) {
+        case STAGE_BEGIN_FRAME: return "begin_frame";
+        case STAGE_APPEND_STREAM: return "append_stream";
+        case STAGE_CHECKSUM: return "checksum";
+        case STAGE_PUBLISH: return "publish";
+        case STAGE_READER_WAKE: return "reader_wake";
+        case STAGE_VALIDATE: return "validate";
+        case STAGE_DECODE: return "decode";
+        default: return nullptr;
+        }
+    }
+
+#pragma pack(push, 1)
+    struct TraceRecord {
+        std::uint64_t start_ns, frame_id;
+        std::uint32_t dur_ns, stage, seq, arg, tid, reserved;
+    };
+    struct TraceFileHeader {
+        std::uint64_t magic;
+        std::uint32_t version, pid;
+        std::uint32_t role_len, name_count;
+        std::uint64_t record_count;
+    };
+    struct TraceNameEntry {
+        std::uint32_t stage, name_len;
+    };
+#pragma pack(pop)
+
+    class Tracer {
+    public:
+        static Tracer& instance() noexcept {
+            static Tracer t;
+            return t;
+        }
+
+        static std::uint64_t now_ns() noexcept {
+            return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        bool enable(std::string_view role, std::uint32_t capacity = 1u << 16) {
+            if (capacity == 0u || (capacity & (capacity - 1u)) != 0u) return false;
+            std::lock_guard lock(mu_);
+            if (!cells_) {
+                cells_ = std::make_unique<Cell[]>(capacity);
+                mask_  = capacity - 1u;
+            }
+            role_.assign(role.begin(), role.end());
+            on_.store(true, std::memory_order_release);
+            return true;
+        }
+
+        bool enable_from_env(std::string_view role) {
+            const char* path = std::getenv("SHMX_TRACE");
+            if (!path || !*path) return false;
+            path_ = path;
+            if (!role.empty()) {
+                path_ += '.';
+                path_.append(role.begin(), role.end());
+            }
+            return enable(role);
+        }
+
+        void disable() noexcept {
+            on_.store(false, std::memory_order_release);
+        }
+
+        [[nodiscard]] bool enabled() const noexcept {
+            return on_.load(std::memory_order_relaxed);
+        }
+
+        void name_stage(std::uint32_t stage, std::string name) {
+            std::lock_guard lock(mu_);
+            for (auto& [s, n] : names_) {
+                if (s == stage) {
+                    n = std::move(name);
+                    return;
+                }
+            }
+            names_.emplace_back(stage, std::move(name));
+        }
+
+        void record(std::uint32_t stage, std::uint64_t frame_id, std::uint32_t seq, std::uint32_t arg, std::uint64_t start_ns, std::uint64_t end_ns) noexcept {
+            if (!enabled()) return;
+            const auto idx = head_.fetch_add(1u, std::memory_order_relaxed);
+            auto& c        = cells_[idx & mask_];
+            c.seq.store(0u, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            const auto dur = end_ns > start_ns ? end_ns - start_ns : 0u;
+            c.rec          = TraceRecord{start_ns, frame_id, static_cast<std::uint32_t>(dur > 0xFFFFFFFFull ? 0xFFFFFFFFull : dur), stage, seq, arg, thread_index(), 0u};
+            c.seq.store(idx + 1u, std::memory_order_release);
+        }
+
+        void mark(std::uint32_t stage, std::uint64_t frame_id, std::uint32_t arg = 0u) noexcept {
+            const auto t = now_ns();
+            record(stage, frame_id, 0u, arg, t, t);
+        }
+
+        [[nodiscard]] std::vector<TraceRecord> snapshot() const {
+            std::vector<TraceRecord> out;
+            if (!cells_) return out;
+            const auto head = head_.load(std::memory_order_acquire);
+            const auto cap  = static_cast<std::uint64_t>(mask_) + 1u;
+            const auto n    = head < cap ? head : cap;
+            out.reserve(static_cast<std::size_t>(n));
+            for (auto i = head - n; i < head; ++i) {
+                const auto& c = cells_[i & mask_];
+                if (c.seq.load(std::memory_order_acquire) != i + 1u) continue;
+                const TraceRecord r = c.rec;
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (c.seq.load(std::memory_order_relaxed) != i + 1u) continue;
+                out.push_back(r);
+            }
+            return out;
+        }
+
+        bool dump(const std::string& path) const {
+            const auto recs = snapshot();
+            std::vector<std::pair<std::uint32_t, std::string>> names;
+            std::string role;
+            {
+                std::lock_guard lock(mu_);
+                names = names_;
+                role  = role_;
+            }
+            std::FILE* f = std::fopen(path.c_str(), "wb");
+            if (!f) return false;
+            TraceFileHeader h{TRACE_MAGIC, TRACE_VERSION, current_pid(), static_cast<std::uint32_t>(role.size()), static_cast<std::uint32_t>(names.size()), recs.size()};
+            bool ok = std::fwrite(&h, sizeof(h), 1, f) == 1;
+            ok      = ok && (role.empty() || std::fwrite(role.data(), role.size(), 1, f) == 1);
+            for (const auto& [stage, name] : names) {
+                TraceNameEntry e{stage, static_cast<std::uint32_t>(name.size())};
+                ok = ok && std::fwrite(&e, sizeof(e), 1, f) == 1;
+                ok = ok && (name.empty() || std::fwrite(name.data(), name.size(), 1, f) == 1);
+            }
+            ok = ok && (recs.empty() || std::fwrite(recs.data(), sizeof(TraceRecord), recs.size(), f) == recs.size());
+            return std::fclose(f) == 0 && ok;
+        }
+
+        bool dump_env() const {
+            return !path_.empty() && dump(path_);
+        }
+
+    private:
+        struct Cell {
+            std::atomic<std::uint64_t> seq{0};
+            TraceRecord rec{};
+        };
+
+        Tracer() = default;
+
+        static std::uint32_t current_pid() noexcept {
+#if defined(_WIN32)
+            return static_cast<std::uint32_t>(::GetCurrentProcessId());
+#else
+            return static_cast<std::uint32_t>(::getpid());
+#endif
+        }
+        static std::uint32_t thread_index() noexcept {
+            static std::atomic<std::uint32_t> next{1};
+            thread_local const std::uint32_t idx = next.fetch_add(1u, std::memory_order_relaxed);
+            return idx;
+        }
+
+        std::unique_ptr<Cell[]> cells_;
+        std::uint32_t mask_ = 0;
+        std::atomic<std::uint64_t> head_{0};
+        std::atomic<bool> on_{false};
+        mutable std::mutex mu_;
+        std::string role_, path_;
+        std::vector<std::pair<std::uint32_t, std::string>> names_;
+    };
+
+    class TraceScope {
+    public:
+        explicit TraceScope(std::uint32_t stage, std::uint64_t frame_id = 0u, std::uint32_t seq = 0u, std::uint32_t arg = 0u) noexcept : stage_(stage), seq_(seq), arg_(arg), frame_id_(frame_id), start_(Tracer::instance().enabled() ? Tracer::now_ns() : 0u) {}
+        ~TraceScope() {
+            if (start_) Tracer::instance().record(stage_, frame_id_, seq_, arg_, start_, Tracer::now_ns());
+        }
+        TraceScope(const TraceScope&)            = delete;
+        TraceScope& operator=(const TraceScope&) = delete;
+
+        void set_frame(std::uint64_t frame_id) noexcept {
+            frame_id_ = frame_id;
+        }
+        void set_seq(std::uint32_t seq) noexcept {
+            seq_ = seq;
+        }
+
+    private:
+        std::uint32_t stage_, seq_, arg_;
+        std::uint64_t frame_id_, start_;
+    };
+
+} // namespace shmx
+#endif // SHMX_TRACE_H
@@ -0,0 +1,266 @@
+#ifndef SHMX_WINDOW_H
+#define SHMX_WINDOW_H
+#include "shmx_client.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace shmx {
+
+    inline constexpr std::size_t WINDOW_MIRROR_SLACK = 64u << 10;
+
+    class MirrorRing {
+    public:
+        MirrorRing() = default;
+        MirrorRing(const MirrorRing&)            = delete;
+        MirrorRing& operator=(const MirrorRing&) = delete;
+        ~MirrorRing() {
+            reset();
+        }
+
+        [[nodiscard]] static std::size_t page_size() noexcept {
+#if defined(__linux__)
+            return static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+#else
+            return 4096u;
+#endif
+        }
+
+        bool init(std::size_t bytes, bool try_mirror = true) {
+            reset();
+            if (bytes == 0u) return false;
+#if defined(__linux__)
+            if (try_mirror && bytes % page_size() == 0u) map_twice(bytes);
+#else
+            (void) try_mirror;
+#endif
+            if (!base_) {
+                fallback_.assign(2u * bytes, 0u);
+                base_ = fallback_.data();
+            }
+            size_ = bytes;
+            return true;
+        }
+
+        void reset() noexcept {
+#if defined(__linux__)
+            if (mapped_) ::munmap(base_, 2u * size_);
+#endif
+            fallback_.clear();
+            fallback_.shrink_to_fit();
+            base_   = nullptr;
+            size_   = 0;
+            mapped_ = false;
+        }
+
+        [[nodiscard]] std::uint8_t* data() const noexcept {
+            return base_;
+        }
+        [[nodiscard]] std::size_t size() const noexcept {
+            return size_;
+        }
+        [[nodiscard]] bool mapped() const noexcept {
+            return mapped_;
+        }
+
+        void publish(std::size_t offset, std::size_t bytes) noexcept {
+            if (!mapped_ && bytes) std::memcpy(base_ + size_ + offset, base_ + offset, bytes);
+        }
+
+    private:
+#if defined(__linux__)
+        void map_twice(std::size_t bytes) noexcept {
+            const int fd = ::memfd_create("shmx_window", MFD_CLOEXEC);
+            if (fd < 0) return;
+            void* region = MAP_FAILED;
+            if (::ftruncate(fd, static_cast<off_t>(bytes)) == 0) region = ::mmap(nullptr, 2u * bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (region != MAP_FAILED) {
+                auto* b = static_cast<std::uint8_t*>(region);
+                if (::mmap(b, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED && ::mmap(b + bytes, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED) {
+                    base_   = b;
+                    mapped_ = true;
+                } else {
+                    ::munmap(region, 2u * bytes);
+                }
+            }
+            ::close(fd);
+        }
+#endif
+
+        std::uint8_t* base_ = nullptr;
+        std::size_t size_   = 0;
+        bool mapped_        = false;
+        std::vector<std::uint8_t> fallback_;
+    };
+
+    class WindowAccumulator {
+    public:
+        WindowAccumulator() = default;
+        WindowAccumulator(const WindowAccumulator&)            = delete;
+        WindowAccumulator& operator=(const WindowAccumulator&) = delete;
+
+        bool track(std::uint32_t stream_id, std::uint32_t elem_count, std::uint32_t value_bytes, std::uint32_t depth) {
+            if (elem_count == 0u || value_bytes == 0u || depth == 0u) return false;
+            const std::size_t frame_bytes = static_cast<std::size_t>(elem_count) * value_bytes;
+            const std::size_t page        = MirrorRing::page_size();
+            const std::size_t step        = page / std::gcd(page, frame_bytes);
+            std::size_t cap               = (depth + step - 1u) / step * step;
+            const bool mirror             = cap * frame_bytes <= 2u * depth * frame_bytes + WINDOW_MIRROR_SLACK;
+            if (!mirror) cap = depth;
+            auto& h = streams_[stream_id];
+            if (!h.values.init(cap * frame_bytes, mirror)) {
+                streams_.erase(stream_id);
+                return false;
+            }
+            h.elem_count  = elem_count;
+            h.value_bytes = value_bytes;
+            h.frame_bytes = frame_bytes;
+            h.depth       = depth;
+            h.cap         = static_cast<std::uint32_t>(cap);
+            h.head        = 0;
+            h.count       = 0;
+            h.frame_ids.assign(2u * cap, 0u);
+            h.sim_times.assign(2u * cap, 0.0);
+            return true;
+        }
+
+        bool track(const StaticStreamInfo& info, std::uint32_t elem_count, std::uint32_t depth) {
+            return track(info.id, elem_count, info.bytes_per_elem, depth);
+        }
+
+        void untrack(std::uint32_t stream_id) {
+            streams_.erase(stream_id);
+        }
+
+        std::uint32_t push(const DecodedFrame& df, std::uint64_t frame_id, double sim_time) {
+            std::uint32_t pushed = 0;
+            for (const auto& [sid, item] : df.streams) {
+                const auto it = streams_.find(sid);
+                if (it == streams_.end()) continue;
+                if (append(it->second, item, frame_id, sim_time))
+                    ++pushed;
+                else
+                    ++dropped_;
+            }
+            return pushed;
+        }
+
+        [[nodiscard]] bool next(Client& cli, std::uint64_t timeout_ns) {
+            FrameView fv;
+            if (!cli.next(fv, timeout_ns) || !Client::decode(fv, df_)) return false;
+            const auto* GH = cli.header();
+            const auto fid = fv.fh->frame_id.load(std::memory_order_acquire);
+            (void) push(df_, fid, fv.fh->sim_time);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (GH->reserve_index.load(std::memory_order_acquire) - fv.seq < GH->slots && fv.fh->frame_id.load(std::memory_order_acquire) == fid) return true;
+            for (auto& [sid, h] : streams_) unwind(h, fid);
+            ++torn_;
+            return false;
+        }
+
+        [[nodiscard]] std::uint32_t size(std::uint32_t stream_id) const noexcept {
+            const auto* h = find(stream_id);
+            return h ? h->count : 0u;
+        }
+
+        template <class T>
+        [[nodiscard]] std::span<const T> window(std::uint32_t stream_id, std::uint32_t frames) const noexcept {
+            const auto* h = find(stream_id);
+            if (!h || h->value_bytes % sizeof(T) != 0u) return {};
+            const auto k = std::min(frames, h->count);
+            return {reinterpret_cast<const T*>(h->values.data() + first_slot(*h, k) * h->frame_bytes), k * h->frame_bytes / sizeof(T)};
+        }
+
+        [[nodiscard]] std::span<const std::uint64_t> frame_ids(std::uint32_t stream_id, std::uint32_t frames) const noexcept {
+            const auto* h = find(stream_id);
+            if (!h) return {};
+            const auto k = std::min(frames, h->count);
+            return {h->frame_ids.data() + first_slot(*h, k), k};
+        }
+
+        [[nodiscard]] std::span<const double> sim_times(std::uint32_t stream_id, std::uint32_t frames) const noexcept {
+            const auto* h = find(stream_id);
+            if (!h) return {};
+            const auto k = std::min(frames, h->count);
+            return {h->sim_times.data() + first_slot(*h, k), k};
+        }
+
+        [[nodiscard]] bool mapped(std::uint32_t stream_id) const noexcept {
+            const auto* h = find(stream_id);
+            return h && h->values.mapped();
+        }
+
+        [[nodiscard]] std::uint64_t dropped() const noexcept {
+            return dropped_;
+        }
+        [[nodiscard]] std::uint64_t torn() const noexcept {
+            return torn_;
+        }
+
+    private:
+        struct History {
+            MirrorRing values;
+            std::vector<std::uint64_t> frame_ids;
+            std::vector<double> sim_times;
+            std::size_t frame_bytes   = 0;
+            std::uint32_t elem_count  = 0;
+            std::uint32_t value_bytes = 0;
+            std::uint32_t depth = 0, cap = 0, head = 0, count = 0;
+        };
+
+        const History* find(std::uint32_t stream_id) const noexcept {
+            const auto it = streams_.find(stream_id);
+            return it == streams_.end() ? nullptr : &it->second;
+        }
+
+        static std::uint32_t first_slot(const History& h, std::uint32_t k) noexcept {
+            return (h.head + h.cap - k) % h.cap;
+        }
+
+        static bool append(History& h, const DecodedItem& item, std::uint64_t frame_id, double sim_time) {
+            if (h.count && h.frame_ids[(h.head + h.cap - 1u) % h.cap] >= frame_id) return false;
+            const auto off = static_cast<std::size_t>(h.head) * h.frame_bytes;
+            auto* dst      = h.values.data() + off;
+            if (item.encoding == ENC_DENSE) {
+                if (item.elem_count != h.elem_count || item.bytes != h.frame_bytes) return false;
+                std::memcpy(dst, item.ptr, h.frame_bytes);
+            } else if (item.encoding == ENC_SPARSE || item.encoding == ENC_SAME) {
+                const auto last = (h.head + h.cap - 1u) % h.cap;
+                const bool base = item.encoding == ENC_SPARSE ? h.frame_ids[last] + 1u == frame_id : h.frame_ids[last] >= same_frame_id(item);
+                if (!h.count || !base) return false;
+                std::memcpy(dst, h.values.data() + static_cast<std::size_t>(last) * h.frame_bytes, h.frame_bytes);
+                if (item.encoding == ENC_SPARSE && !apply_sparse_update(dst, h.elem_count, h.value_bytes, item)) return false;
+            } else {
+                return false;
+            }
+            h.values.publish(off, h.frame_bytes);
+            h.frame_ids[h.head] = h.frame_ids[h.head + h.cap] = frame_id;
+            h.sim_times[h.head] = h.sim_times[h.head + h.cap] = sim_time;
+            h.head                                            = (h.head + 1u) % h.cap;
+            h.count                                           = std::min(h.count + 1u, h.depth);
+            return true;
+        }
+
+        static void unwind(History& h, std::uint64_t frame_id) noexcept {
+            const auto last = (h.head + h.cap - 1u) % h.cap;
+            if (!h.count || h.frame_ids[last] != frame_id) return;
+            h.head = last;
+            --h.count;
+        }
+
+        std::unordered_map<std::uint32_t, History> streams_;
+        DecodedFrame df_;
+        std::uint64_t dropped_ = 0, torn_ = 0;
+    };
+
+} // namespace shmx
+#endif // SHMX_WINDOW_H
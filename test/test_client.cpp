@@ -1,5 +1,6 @@
 #include "shmx_client.h"
 #include "shmx_common.h"
+#include "shmx_trace.h"
 #include <atomic>
 #include <chrono>
 #include <csignal>
@@ -26,6 +27,7 @@ namespace {
     constexpr std::uint32_t CTRL_HELLO     = 0x48454C4Fu;
     constexpr std::uint32_t CTRL_HEARTBEAT = 0x48425254u;
     constexpr std::uint32_t CTRL_BYE       = 0x4259455Fu;
+    constexpr std::uint32_t RPC_GET_SEQ    = 1u;
     struct HelloMsg {
         std::uint32_t ver_major;
         std::uint32_t ver_minor;
@@ -53,6 +55,8 @@ int main(int argc, char** argv) {
     std::signal(SIGTERM, sigint_handler);
 #endif
 
+    if (Tracer::instance().enable_from_env("client")) std::printf("[client] tracing enabled\n");
+
     Client cli;
     bool connected             = false;
     std::uint64_t last_session = 0;
@@ -60,6 +64,7 @@ int main(int argc, char** argv) {
     auto t0                   = std::chrono::steady_clock::now();
     std::uint64_t recv_in_sec = 0, last_print = 0;
     auto last_hb = std::chrono::steady_clock::now();
+    RpcFuture seq_rpc;
 
     auto try_open = [&](const char* reason) {
         if (connected) return;
@@ -122,6 +127,7 @@ int main(int argc, char** argv) {
         const double sim        = fv.fh->sim_time;
 
         if (fid != seen.frame_id) {
+            Tracer::instance().mark(STAGE_READER_WAKE, fid);
             seen.frame_id = fid;
             seen.time     = std::chrono::steady_clock::now();
             ++recv_in_sec;
@@ -140,6 +146,12 @@ int main(int argc, char** argv) {
             std::printf("[client] frame %llu sim %.3f seq %llu tlv %u bytes %u\n", static_cast<unsigned long long>(fid), sim, static_cast<unsigned long long>(tick_seq), fv.fh->tlv_count, fv.fh->payload_bytes);
         }
 
+        if (seq_rpc.pending() && seq_rpc.ready()) {
+            std::uint64_t server_seq = 0;
+            if (seq_rpc.status() == RPC_OK && seq_rpc.data().size() == sizeof(server_seq)) std::memcpy(&server_seq, seq_rpc.data().data(), sizeof(server_seq));
+            std::printf("[client] rpc get_seq status %u seq %llu\n", seq_rpc.status(), static_cast<unsigned long long>(server_seq));
+        }
+
         auto now = std::chrono::steady_clock::now();
         auto sec = std::chrono::duration_cast<std::chrono::seconds>(now - t0).count();
         if (static_cast<std::uint64_t>(sec) != last_print) {
@@ -152,12 +164,14 @@ int main(int argc, char** argv) {
             last_hb             = now;
             std::uint64_t stamp = static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
             (void) cli.control_send(CTRL_HEARTBEAT, &stamp, sizeof(stamp));
+            if (!seq_rpc.pending()) seq_rpc = cli.call(RPC_GET_SEQ, nullptr, 0u);
         }
 
         std::this_thread::sleep_for(std::chrono::milliseconds(15));
     }
 
     std::printf("[client] exiting\n");
+    if (Tracer::instance().enabled() && !Tracer::instance().dump_env()) std::printf("[client] trace dump failed\n");
     if (connected) send_bye_best_effort(cli);
     cli.close();
     return 0;
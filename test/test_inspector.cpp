@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <atomic>
+#include <bit>
 #include <chrono>
 #include <cstdio>
 #include <sstream>
@@ -96,6 +97,7 @@ int main(int argc, char** argv) {
     enter_alt();
     std::uint32_t last_gen = 0;
     std::vector<InspectDirEntry> dir;
+    InspectStats stats;
     const size_t WBAR = 80;
     while (true) {
         if (!ins.header()) {
@@ -109,6 +111,7 @@ int main(int argc, char** argv) {
             }
             last_gen = 0;
             dir.clear();
+            stats.clear();
         }
         const auto* H  = ins.header();
         const auto gen = H->static_gen.load(std::memory_order_acquire);
@@ -117,6 +120,8 @@ int main(int argc, char** argv) {
             last_gen = gen;
         }
         auto L = ins.layout();
+        stats.add(ins.sample());
+        const auto R = stats.rates();
 
         std::uint64_t total_bytes   = (std::uint64_t) L.slots_offset + (std::uint64_t) L.slot_stride * (std::uint64_t) L.slots;
         std::uint64_t static_total  = L.static_cap;
@@ -145,6 +150,10 @@ int main(int argc, char** argv) {
         if (L.static_cap > L.static_used) paint_seg((std::uint64_t) L.static_offset + L.static_used, L.static_cap - L.static_used, 's');
         paint_seg(L.readers_offset, readers_total, 'R');
         if (L.control_per_reader) paint_seg(L.control_offset, control_total, 'C');
+        if (L.reply_per_reader) paint_seg(L.reply_offset, (std::uint64_t) L.reply_stride * L.reader_slots, 'P');
+        paint_seg(L.kv_offset, L.kv_bytes, 'K');
+        paint_seg(L.queue_offset, L.queue_bytes, 'Q');
+        paint_seg(L.sync_offset, (std::uint64_t) L.sync_cells * SYNC_CELL_BYTES, 'Y');
         paint_seg(L.slots_offset, frames_total, 'A');
         std::uint32_t latest_idx = 0;
         if (L.slots > 0) {
@@ -156,13 +165,9 @@ int main(int argc, char** argv) {
             size_t a            = map_pos(start);
             size_t b            = map_pos(start + L.slot_stride);
             if (b <= a) b = std::min(a + 1, WBAR);
-            InspectFrameView fv{};
-            bool ok   = ins.slot_view(i, fv);
+            InspectSlotHeader sh{};
             char fill = '.';
-            if (ok && fv.bytes > 0 && fv.checksum_ok)
-                fill = '#';
-            else if (ok && fv.bytes > 0 && !fv.checksum_ok)
-                fill = '!';
+            if (ins.slot_header(i, sh) && sh.valid) fill = sh.stable ? '#' : '!';
             if (i == latest_idx) fill = 'L';
             for (size_t k = a; k < b && k < WBAR; ++k) bar[k] = fill;
         }
@@ -171,7 +176,7 @@ int main(int argc, char** argv) {
         os << "\x1b[1m\x1b[35mshmx inspector\x1b[0m  name " << name << "\n";
         os << "session " << (unsigned long long) H->session_id << "  ver " << H->ver_major << "." << H->ver_minor << "  readers " << H->readers_connected.load() << "\n";
         os << "[" << std::string(bar.begin(), bar.end()) << "]\n";
-        os << "legend: H header  S static-used  s static-free  R readers  C control  A slots-area  L latest  # ok  ! bad  . empty\n\n";
+        os << "legend: H header  S static-used  s static-free  R readers  C control  P replies  K kv  Q queue  Y sync  A slots-area  L latest  # published  ! changing  . empty\n\n";
 
         {
             std::vector<std::string> headers{"field", "value"};
@@ -193,6 +198,28 @@ int main(int argc, char** argv) {
                 v << "off " << L.control_offset << " stride " << L.control_stride << " per " << L.control_per_reader << " slots " << L.reader_slots << " -> total " << human_bytes(control_total);
                 rows.push_back({"control", v.str()});
             }
+            if (L.reply_per_reader) {
+                std::ostringstream v;
+                v << "off " << L.reply_offset << " stride " << L.reply_stride << " per " << L.reply_per_reader << " slots " << L.reader_slots << " -> total " << human_bytes((std::uint64_t) L.reply_stride * L.reader_slots);
+                rows.push_back({"replies", v.str()});
+            }
+            if (L.kv_bytes) {
+                std::ostringstream v;
+                v << "off " << L.kv_offset << " entries";
+                for (std::uint32_t c = 0; c < KV_CLASSES; ++c) v << " " << L.kv_entries[c] << "x" << KV_CLASS_BYTES[c];
+                v << " live " << ins.list_kv().size() << " -> total " << human_bytes(L.kv_bytes);
+                rows.push_back({"kv", v.str()});
+            }
+            if (L.queue_cells) {
+                std::ostringstream v;
+                v << "off " << L.queue_offset << " cells " << L.queue_cells << " x " << L.queue_cell_bytes << " B depth " << ins.queue_depth() << " -> total " << human_bytes(L.queue_bytes);
+                rows.push_back({"queue", v.str()});
+            }
+            if (L.sync_cells) {
+                std::ostringstream v;
+                v << "off " << L.sync_offset << " cells " << L.sync_cells << " x " << SYNC_CELL_BYTES << " B -> total " << human_bytes((std::uint64_t) L.sync_cells * SYNC_CELL_BYTES);
+                rows.push_back({"sync", v.str()});
+            }
             {
                 std::ostringstream v;
                 v << "off " << L.slots_offset << " stride " << L.slot_stride << " slots " << L.slots << " cap " << L.frame_bytes_cap << " -> total " << human_bytes(frames_total);
@@ -201,21 +228,73 @@ int main(int argc, char** argv) {
             draw_table(os, headers, rows, widths);
         }
 
+        {
+            std::vector<std::string> headers{"window", "publish", "suppressed", "throughput", "slots valid", "ctrl fill max"};
+            std::vector<size_t> widths{10, 14, 14, 16, 12, 14};
+            std::vector<std::vector<std::string>> rows;
+            char win[32], hz[32], dup[32], bps[48], occ[32], fill[32];
+            std::snprintf(win, sizeof(win), "%.1f s", R.window_s);
+            std::snprintf(hz, sizeof(hz), "%.1f Hz", R.publish_hz);
+            std::snprintf(dup, sizeof(dup), "%.1f Hz", R.suppressed_hz);
+            std::snprintf(bps, sizeof(bps), "%.2f MB/s", R.bytes_per_s / (1024.0 * 1024.0));
+            std::snprintf(occ, sizeof(occ), "%u / %u", R.slots_valid, R.slots);
+            std::snprintf(fill, sizeof(fill), "%.1f %%", R.control_fill_max * 100.0);
+            rows.push_back({win, hz, dup, bps, occ, fill});
+            draw_table(os, headers, rows, widths);
+        }
+
+        {
+            std::vector<std::string> headers{"idx", "id", "lag", "p50", "p90", "p99", "max", "drops", "drop %", "ctrl %"};
+            std::vector<size_t> widths{5, 18, 6, 6, 6, 6, 6, 8, 8, 8};
+            std::vector<std::vector<std::string>> rows;
+            size_t n = std::min<size_t>(R.readers.size(), 10);
+            for (size_t i = 0; i < n; ++i) {
+                const auto& r = R.readers[i];
+                char dr[32], cf[32];
+                std::snprintf(dr, sizeof(dr), "%.2f", r.drop_rate * 100.0);
+                std::snprintf(cf, sizeof(cf), "%.1f", r.control_fill * 100.0);
+                rows.push_back({std::to_string(r.index), std::to_string((unsigned long long) r.reader_id), std::to_string((unsigned long long) r.lag), std::to_string((unsigned long long) r.lag_p50), std::to_string((unsigned long long) r.lag_p90), std::to_string((unsigned long long) r.lag_p99), std::to_string((unsigned long long) r.lag_max), std::to_string((unsigned long long) r.drops), dr, cf});
+            }
+            draw_table(os, headers, rows, widths);
+        }
+
+        {
+            const auto A = stats.advise(0.01);
+            std::vector<std::string> headers{"overrun target", "slots", "advised", "frame cap", "advised", "max payload", "worst overrun"};
+            std::vector<size_t> widths{14, 7, 8, 12, 12, 12, 14};
+            std::vector<std::vector<std::string>> rows;
+            double worst = 0.0;
+            for (const auto& r : A.readers) worst = std::max(worst, r.overrun_rate);
+            char tg[32], wo[32];
+            std::snprintf(tg, sizeof(tg), "%.2f %%", A.target * 100.0);
+            std::snprintf(wo, sizeof(wo), "%.2f %%", worst * 100.0);
+            rows.push_back({tg, std::to_string(A.slots), std::to_string(A.slots_recommended), std::to_string(A.frame_bytes_cap), std::to_string(A.frame_bytes_cap_recommended), std::to_string(A.frame_bytes_max), wo});
+            draw_table(os, headers, rows, widths);
+        }
+
         {
             auto readers = ins.snapshot_readers();
-            std::vector<std::string> headers{"idx", "in_use", "id", "last", "hb"};
-            std::vector<size_t> widths{5, 7, 18, 14, 14};
+            std::vector<std::string> headers{"idx", "in_use", "id", "last", "ack", "lod", "decim", "hb"};
+            std::vector<size_t> widths{5, 7, 18, 14, 14, 5, 14, 14};
             std::vector<std::vector<std::string>> rows;
             size_t n = std::min<size_t>(readers.size(), 10);
             for (size_t i = 0; i < n; ++i) {
-                rows.push_back({std::to_string(i), readers[i].in_use ? "1" : "0", std::to_string((unsigned long long) readers[i].reader_id), std::to_string((unsigned long long) readers[i].last_frame_seen), std::to_string((unsigned long long) readers[i].heartbeat)});
+                char dec[32] = "-";
+                if (readers[i].every_n > 1u && readers[i].min_interval_ns)
+                    std::snprintf(dec, sizeof(dec), "1/%u %.1fHz", readers[i].every_n, 1e9 / static_cast<double>(readers[i].min_interval_ns));
+                else if (readers[i].every_n > 1u)
+                    std::snprintf(dec, sizeof(dec), "1/%u", readers[i].every_n);
+                else if (readers[i].min_interval_ns)
+                    std::snprintf(dec, sizeof(dec), "%.1fHz", 1e9 / static_cast<double>(readers[i].min_interval_ns));
+                rows.push_back({std::to_string(i), readers[i].in_use ? "1" : "0", std::to_string((unsigned long long) readers[i].reader_id), std::to_string((unsigned long long) readers[i].last_frame_seen), readers[i].lockstep ? std::to_string((unsigned long long) readers[i].acked_frame) : std::string("-"), readers[i].lod_mask ? std::to_string(std::popcount(readers[i].lod_mask)) : std::string("-"), dec, std::to_string((unsigned long long) readers[i].heartbeat)});
             }
             draw_table(os, headers, rows, widths);
         }
 
         {
             InspectFrameView fv{};
-            if (ins.latest(fv)) {
+            if (ins.latest(fv, false)) {
+                (void) ins.verify(fv);
                 auto fid = fv.fh->frame_id.load(std::memory_order_acquire);
                 std::vector<std::string> headers{"frame_id", "tlv", "bytes", "sim", "checksum"};
                 std::vector<size_t> widths{18, 6, 12, 14, 10};
@@ -226,20 +305,28 @@ int main(int argc, char** argv) {
                         std::snprintf(buf, sizeof(buf), "%.6f", fv.fh->sim_time);
                         return std::string(buf);
                     }(),
-                    fv.checksum_ok ? "ok" : "bad"});
+                    !fv.verified ? "skipped" : fv.checksum_ok ? "ok" : "bad"});
                 draw_table(os, headers, rows, widths);
 
                 std::vector<std::pair<std::uint32_t, InspectItem>> streams;
                 ins.decode_frame(fv, streams);
-                std::vector<std::string> h2{"stream_id", "name", "elems", "bytes"};
-                std::vector<size_t> w2{10, 26, 8, 12};
+                std::vector<std::string> h2{"stream_id", "name", "elems", "bytes", "min", "max", "nan"};
+                std::vector<size_t> w2{10, 26, 8, 12, 12, 12, 8};
                 std::vector<std::vector<std::string>> r2;
                 size_t m = std::min<size_t>(streams.size(), 10);
                 for (size_t i = 0; i < m; ++i) {
                     auto sid       = streams[i].first;
                     auto it        = std::find_if(dir.begin(), dir.end(), [&](const InspectDirEntry& e) { return e.stream_id == sid; });
                     std::string nm = it != dir.end() ? it->name : "?";
-                    r2.push_back({std::to_string(sid), nm, std::to_string(streams[i].second.elem_count), human_bytes(streams[i].second.bytes)});
+                    StreamStatsTLV ss{};
+                    if (ins.stream_stats(fv, sid, ss)) {
+                        char lo[32], hi[32];
+                        std::snprintf(lo, sizeof(lo), "%.4g", ss.min);
+                        std::snprintf(hi, sizeof(hi), "%.4g", ss.max);
+                        r2.push_back({std::to_string(sid), nm, std::to_string(streams[i].second.elem_count), human_bytes(streams[i].second.bytes), lo, hi, std::to_string((unsigned long long) ss.nan_count)});
+                    } else {
+                        r2.push_back({std::to_string(sid), nm, std::to_string(streams[i].second.elem_count), human_bytes(streams[i].second.bytes), "-", "-", "-"});
+                    }
                 }
                 draw_table(os, h2, r2, w2);
             } else {
@@ -0,0 +1,82 @@
+#include "shmx_client.h"
+#include "shmx_server.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace shmx;
+
+namespace {
+    constexpr std::uint32_t STREAM_ID = 1u;
+    constexpr std::uint32_t ELEMS     = 4096u;
+    constexpr std::uint32_t STATES    = 1500u;
+    constexpr auto PUBLISH_GAP        = std::chrono::microseconds(300);
+
+    struct RunResult {
+        std::uint64_t calls, ok, bad;
+    };
+
+    // Each state is published twice; with suppression on, the second copy is handed back without becoming a frame.
+    RunResult run(const std::string& name, bool suppress) {
+        Server srv;
+        const std::vector<StaticStream> streams{{STREAM_ID, DT_F32, 1, LAYOUT_SOA_SCALAR, sizeof(float), "value", {}}};
+        const Server::Config cfg{.name = name, .slots = 2, .reader_slots = 2, .frame_bytes_cap = ELEMS * sizeof(float) + 256u, .suppress_duplicates = suppress};
+        if (!srv.create(cfg, streams)) return {0, 0, 1};
+        std::atomic<bool> done{false};
+        std::thread producer([&] {
+            std::vector<float> v(ELEMS);
+            for (std::uint32_t k = 1; k <= STATES; ++k) {
+                std::fill(v.begin(), v.end(), static_cast<float>(k));
+                for (int copy = 0; copy < 2; ++copy) {
+                    auto fm = srv.begin_frame();
+                    (void) Server::append_stream(fm, STREAM_ID, v.data(), ELEMS, ELEMS * sizeof(float));
+                    (void) srv.publish_frame(fm, static_cast<double>(k));
+                }
+                std::this_thread::sleep_for(PUBLISH_GAP);
+            }
+            done = true;
+        });
+
+        RunResult r{0, 0, 0};
+        Client cli;
+        if (!cli.open(name)) r.bad = 1;
+        std::vector<float> out(ELEMS);
+        while (!done.load() && r.bad == 0u) {
+            const auto latest = static_cast<double>(srv.last_frame_id());
+            InterpStream s{STREAM_ID, DT_F32, out.data(), out.size() * sizeof(float), 0u, false};
+            InterpResult res{};
+            ++r.calls;
+            if (!cli.interpolate(latest - 0.5, {&s, 1}, res)) continue;
+            ++r.ok;
+            // A frame's values and sim_time are both its state; without suppression every state takes two frame ids.
+            const auto state  = [&](std::uint64_t fid) { return static_cast<double>(suppress ? fid : (fid + 1u) / 2u); };
+            const double sa   = res.fallback ? 0.0 : state(res.frame_a);
+            const double sb   = state(res.frame_b);
+            const double want = res.fallback ? sb : sa + (sb - sa) * res.alpha;
+            for (std::uint32_t i = 0; i < ELEMS; ++i) {
+                if (std::fabs(out[i] - want) > 1e-3 * want) {
+                    std::printf("[interp] suppress=%d fa=%llu fb=%llu alpha=%.3f out[%u]=%.3f want %.3f\n", suppress ? 1 : 0, static_cast<unsigned long long>(res.frame_a), static_cast<unsigned long long>(res.frame_b), res.alpha, i, out[i], want);
+                    ++r.bad;
+                    break;
+                }
+            }
+        }
+        producer.join();
+        return r;
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::string name = (argc >= 2) ? argv[1] : std::string("shmx_interp_test");
+    int rc                 = 0;
+    for (const bool suppress : {false, true}) {
+        const auto r = run(name + (suppress ? "_dedup" : "_plain"), suppress);
+        std::printf("[interp] suppress=%d calls %llu ok %llu bad %llu\n", suppress ? 1 : 0, static_cast<unsigned long long>(r.calls), static_cast<unsigned long long>(r.ok), static_cast<unsigned long long>(r.bad));
+        if (r.bad != 0u || r.ok == 0u) rc = 1;
+    }
+    return rc;
+}
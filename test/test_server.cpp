@@ -1,5 +1,6 @@
 #include "shmx_common.h"
 #include "shmx_server.h"
+#include "shmx_trace.h"
 #include <atomic>
 #include <chrono>
 #include <csignal>
@@ -29,6 +30,7 @@ namespace {
     constexpr std::uint32_t CTRL_HELLO     = 0x48454C4Fu;
     constexpr std::uint32_t CTRL_HEARTBEAT = 0x48425254u;
     constexpr std::uint32_t CTRL_BYE       = 0x4259455Fu;
+    constexpr std::uint32_t RPC_GET_SEQ    = 1u;
     struct HelloMsg {
         std::uint32_t ver_major;
         std::uint32_t ver_minor;
@@ -48,12 +50,14 @@ int main(int argc, char** argv) {
     std::signal(SIGTERM, sigint_handler);
 #endif
 
-    Server::Config cfg{.name = name, .slots = 4u, .reader_slots = 16u, .static_bytes_cap = 4096u, .frame_bytes_cap = 65536u, .control_per_reader = 4096u};
+    Server::Config cfg{.name = name, .slots = 4u, .reader_slots = 16u, .static_bytes_cap = 4096u, .frame_bytes_cap = 65536u, .control_per_reader = 4096u, .reply_per_reader = 4096u, .stream_stats = true};
 
     std::vector<StaticStream> streams;
     streams.push_back(StaticStream{.stream_id = 42u, .element_type = DT_U64, .components = 1u, .layout = LAYOUT_SOA_SCALAR, .bytes_per_elem = static_cast<std::uint32_t>(sizeof(std::uint64_t)), .name_utf8 = "tick_seq", .extra = {}});
     streams.push_back(StaticStream{.stream_id = 43u, .element_type = DT_F64, .components = 1u, .layout = LAYOUT_SOA_SCALAR, .bytes_per_elem = static_cast<std::uint32_t>(sizeof(double)), .name_utf8 = "tick_sim", .extra = {}});
 
+    if (Tracer::instance().enable_from_env("server")) std::printf("[server] tracing enabled\n");
+
     Server srv;
     if (!srv.create(cfg, streams)) throw std::runtime_error("server create failed");
 
@@ -61,6 +65,11 @@ int main(int argc, char** argv) {
 
     auto t0           = std::chrono::steady_clock::now();
     std::uint64_t seq = 0, last_print = 0, frames_in_sec = 0;
+    srv.rpc_register(RPC_GET_SEQ, [&](const Server::RpcRequest&, std::vector<std::uint8_t>& out) {
+        out.resize(sizeof(seq));
+        std::memcpy(out.data(), &seq, sizeof(seq));
+        return RPC_OK;
+    });
     std::unordered_map<std::uint64_t, std::chrono::steady_clock::time_point> last_seen;
     std::unordered_set<std::uint64_t> connected_now;
     const auto timeout = std::chrono::seconds(3);
@@ -77,23 +86,22 @@ int main(int argc, char** argv) {
         }
 
         std::vector<Server::ControlMsg> msgs;
-        if (srv.poll_control(msgs, 256u)) {
-            for (const auto& [reader_id, type, data] : msgs) {
-                const auto now = std::chrono::steady_clock::now();
-                if (type == CTRL_HELLO && data.size() == sizeof(HelloMsg)) {
-                    HelloMsg hello{};
-                    std::memcpy(&hello, data.data(), sizeof(hello));
-                    last_seen[reader_id] = now;
-                    if (connected_now.insert(reader_id).second) {
-                        std::printf("[server] reader %llu hello %u.%u\n", static_cast<unsigned long long>(reader_id), hello.ver_major, hello.ver_minor);
-                    }
-                } else if (type == CTRL_HEARTBEAT && data.size() == sizeof(std::uint64_t)) {
-                    last_seen[reader_id] = now;
-                } else if (type == CTRL_BYE) {
-                    if (connected_now.erase(reader_id) > 0) {
-                        last_seen.erase(reader_id);
-                        std::printf("[server] reader %llu bye\n", static_cast<unsigned long long>(reader_id));
-                    }
+        (void) srv.serve_rpc(msgs, 256u);
+        for (const auto& [reader_id, type, data] : msgs) {
+            const auto now = std::chrono::steady_clock::now();
+            if (type == CTRL_HELLO && data.size() == sizeof(HelloMsg)) {
+                HelloMsg hello{};
+                std::memcpy(&hello, data.data(), sizeof(hello));
+                last_seen[reader_id] = now;
+                if (connected_now.insert(reader_id).second) {
+                    std::printf("[server] reader %llu hello %u.%u\n", static_cast<unsigned long long>(reader_id), hello.ver_major, hello.ver_minor);
+                }
+            } else if (type == CTRL_HEARTBEAT && data.size() == sizeof(std::uint64_t)) {
+                last_seen[reader_id] = now;
+            } else if (type == CTRL_BYE) {
+                if (connected_now.erase(reader_id) > 0) {
+                    last_seen.erase(reader_id);
+                    std::printf("[server] reader %llu bye\n", static_cast<unsigned long long>(reader_id));
                 }
             }
         }
@@ -133,6 +141,7 @@ int main(int argc, char** argv) {
     }
 
     std::printf("[server] shutdown\n");
+    if (Tracer::instance().enabled() && !Tracer::instance().dump_env()) std::printf("[server] trace dump failed\n");
     srv.destroy();
     return 0;
 }
@@ -0,0 +1,279 @@
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#if defined(_WIN32)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#if defined(_MSC_VER)
+#pragma comment(lib, "ws2_32.lib")
+#endif
+using socket_t                      = SOCKET;
+static constexpr socket_t NO_SOCKET = INVALID_SOCKET;
+static void close_socket(socket_t s) {
+    ::closesocket(s);
+}
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+using socket_t                      = int;
+static constexpr socket_t NO_SOCKET = -1;
+static void close_socket(socket_t s) {
+    ::close(s);
+}
+#endif
+#include "shmx_common.h"
+#include "shmx_inspector.h"
+using namespace shmx;
+
+static std::atomic<bool> g_run{true};
+#if defined(_WIN32)
+BOOL WINAPI console_handler(DWORD) {
+    g_run = false;
+    return TRUE;
+}
+#else
+void sigint_handler(int) {
+    g_run = false;
+}
+#endif
+
+namespace {
+    struct Options {
+        std::string name{"shmx_demo"}, textfile;
+        std::uint16_t port{0};
+        std::uint32_t interval_ms{1000};
+    };
+
+    std::uint64_t now_ns() {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    void metric(std::string& out, const char* name, const char* type, const char* help) {
+        out += "# TYPE ";
+        out += name;
+        out += ' ';
+        out += type;
+        out += "\n# HELP ";
+        out += name;
+        out += ' ';
+        out += help;
+        out += '\n';
+    }
+
+    void sample_line(std::string& out, const char* name, const std::string& labels, double v) {
+        char buf[64];
+        std::snprintf(buf, sizeof(buf), "%.17g", v);
+        out += name;
+        out += '{';
+        out += labels;
+        out += "} ";
+        out += buf;
+        out += '\n';
+    }
+
+    class Exporter {
+    public:
+        explicit Exporter(std::string name) : name_(std::move(name)), seg_("segment=\"" + name_ + "\"") {}
+
+        std::string render() {
+            InspectSample smp{};
+            std::uint32_t readers_connected = 0, static_used = 0, static_cap = 0;
+            const bool up = attach();
+            const auto t0 = now_ns();
+            if (up) {
+                smp               = ins_.sample();
+                const auto* H     = ins_.header();
+                readers_connected = H->readers_connected.load(std::memory_order_acquire);
+                static_used       = H->static_bytes_used;
+                static_cap        = H->static_bytes_cap;
+            }
+            const auto sample_ns = now_ns() - t0;
+
+            std::string out;
+            out.reserve(4096);
+            metric(out, "shmx_up", "gauge", "Whether the segment is attached and valid.");
+            sample_line(out, "shmx_up", seg_, up ? 1.0 : 0.0);
+            metric(out, "shmx_exporter_sample_seconds", "gauge", "Time spent taking the last sample.");
+            sample_line(out, "shmx_exporter_sample_seconds", seg_, static_cast<double>(sample_ns) * 1e-9);
+            if (up) {
+                metric(out, "shmx_frames_published", "counter", "Frames published since the segment was created.");
+                sample_line(out, "shmx_frames_published_total", seg_, static_cast<double>(smp.frame_seq));
+                metric(out, "shmx_bytes_published", "counter", "Frame payload bytes published since the segment was created.");
+                sample_line(out, "shmx_bytes_published_total", seg_, static_cast<double>(smp.bytes_published));
+                metric(out, "shmx_readers_connected", "gauge", "Readers attached to the segment.");
+                sample_line(out, "shmx_readers_connected", seg_, readers_connected);
+                metric(out, "shmx_slots", "gauge", "Frame slots in the ring.");
+                sample_line(out, "shmx_slots", seg_, smp.slots);
+                metric(out, "shmx_slots_valid", "gauge", "Frame slots holding a published frame of the current session.");
+                sample_line(out, "shmx_slots_valid", seg_, smp.slots_valid);
+                metric(out, "shmx_static_bytes", "gauge", "Static directory bytes used.");
+                sample_line(out, "shmx_static_bytes", seg_, static_used);
+                metric(out, "shmx_static_capacity_bytes", "gauge", "Static directory capacity.");
+                sample_line(out, "shmx_static_capacity_bytes", seg_, static_cap);
+                metric(out, "shmx_control_capacity_bytes", "gauge", "Usable bytes per reader control ring.");
+                sample_line(out, "shmx_control_capacity_bytes", seg_, smp.control_cap);
+
+                metric(out, "shmx_reader_lag_frames", "gauge", "frame_seq minus the reader's last seen frame.");
+                for (const auto& r : smp.readers) sample_line(out, "shmx_reader_lag_frames", reader_labels(r), smp.frame_seq > r.last_frame_seen ? static_cast<double>(smp.frame_seq - r.last_frame_seen) : 0.0);
+                metric(out, "shmx_reader_frames_seen", "counter", "Distinct frames the reader has consumed.");
+                for (const auto& r : smp.readers) sample_line(out, "shmx_reader_frames_seen_total", reader_labels(r), static_cast<double>(r.frames_seen));
+                metric(out, "shmx_reader_control_used_bytes", "gauge", "Bytes pending in the reader's control ring.");
+                for (const auto& r : smp.readers) sample_line(out, "shmx_reader_control_used_bytes", reader_labels(r), static_cast<double>(r.control_used));
+            }
+            out += "# EOF\n";
+            return out;
+        }
+
+    private:
+        bool attach() {
+            if (ins_.header()) {
+                const auto* H = ins_.header();
+                if (H->magic == MAGIC && H->session_id == session_) return true;
+                ins_.close();
+            }
+            if (!ins_.open(name_)) return false;
+            session_ = ins_.header()->session_id;
+            return true;
+        }
+
+        std::string reader_labels(const InspectReaderSample& r) const {
+            return seg_ + ",reader=\"" + std::to_string(r.index) + "\",reader_id=\"" + std::to_string(static_cast<unsigned long long>(r.reader_id)) + "\"";
+        }
+
+        std::string name_, seg_;
+        Inspector ins_;
+        std::uint64_t session_ = 0;
+    };
+
+    bool write_textfile(const std::string& path, const std::string& body) {
+        const std::string tmp = path + ".tmp";
+        std::FILE* f          = std::fopen(tmp.c_str(), "wb");
+        if (!f) return false;
+        const bool ok = std::fwrite(body.data(), 1, body.size(), f) == body.size();
+        if (std::fclose(f) != 0 || !ok) return false;
+#if defined(_WIN32)
+        std::remove(path.c_str());
+#endif
+        return std::rename(tmp.c_str(), path.c_str()) == 0;
+    }
+
+    socket_t listen_loopback(std::uint16_t port) {
+        const socket_t s = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (s == NO_SOCKET) return NO_SOCKET;
+        int yes = 1;
+        ::setsockopt(s, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&yes), sizeof(yes));
+        sockaddr_in addr{};
+        addr.sin_family      = AF_INET;
+        addr.sin_port        = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (::bind(s, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0 || ::listen(s, 8) != 0) {
+            close_socket(s);
+            return NO_SOCKET;
+        }
+        return s;
+    }
+
+    bool wait_readable(socket_t s, int timeout_ms) {
+#if defined(_WIN32)
+        WSAPOLLFD p{};
+        p.fd     = s;
+        p.events = POLLRDNORM;
+        return ::WSAPoll(&p, 1, timeout_ms) > 0;
+#else
+        pollfd p{};
+        p.fd     = s;
+        p.events = POLLIN;
+        return ::poll(&p, 1, timeout_ms) > 0;
+#endif
+    }
+
+    void serve_one(socket_t c, Exporter& ex) {
+        char req[2048];
+        if (!wait_readable(c, 1000)) return;
+        const auto n = ::recv(c, req, sizeof(req) - 1, 0);
+        if (n <= 0) return;
+        req[n]               = '\0';
+        const bool metrics   = std::strncmp(req, "GET /metrics", 12) == 0 || std::strncmp(req, "GET / ", 6) == 0;
+        const std::string bd = metrics ? ex.render() : std::string("not found\n");
+        std::string resp     = metrics ? "HTTP/1.1 200 OK\r\nContent-Type: application/openmetrics-text; version=1.0.0; charset=utf-8\r\n" : "HTTP/1.1 404 Not Found\r\nContent-Type: text/plain\r\n";
+        resp += "Connection: close\r\nContent-Length: " + std::to_string(bd.size()) + "\r\n\r\n" + bd;
+        std::size_t off = 0;
+        while (off < resp.size()) {
+            const auto w = ::send(c, resp.data() + off, static_cast<int>(resp.size() - off), 0);
+            if (w <= 0) break;
+            off += static_cast<std::size_t>(w);
+        }
+    }
+
+    bool parse(int argc, char** argv, Options& o) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string a = argv[i];
+            if (i + 1 >= argc) return false;
+            const char* v = argv[++i];
+            if (a == "--name")
+                o.name = v;
+            else if (a == "--listen")
+                o.port = static_cast<std::uint16_t>(std::strtoul(v, nullptr, 10));
+            else if (a == "--textfile")
+                o.textfile = v;
+            else if (a == "--interval-ms")
+                o.interval_ms = static_cast<std::uint32_t>(std::strtoul(v, nullptr, 10));
+            else
+                return false;
+        }
+        return o.port != 0 || !o.textfile.empty();
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    Options o;
+    if (!parse(argc, argv, o)) {
+        std::fprintf(stderr, "usage: %s [--name shm] (--listen PORT | --textfile PATH [--interval-ms N])\n", argv[0]);
+        return 2;
+    }
+#if defined(_WIN32)
+    SetConsoleCtrlHandler(console_handler, TRUE);
+    WSADATA wsa{};
+    if (::WSAStartup(MAKEWORD(2, 2), &wsa) != 0) return 1;
+#else
+    std::signal(SIGINT, sigint_handler);
+    std::signal(SIGTERM, sigint_handler);
+#endif
+
+    Exporter ex(o.name);
+    if (!o.textfile.empty()) {
+        std::printf("[exporter] %s -> %s every %u ms\n", o.name.c_str(), o.textfile.c_str(), o.interval_ms);
+        while (g_run.load()) {
+            if (!write_textfile(o.textfile, ex.render())) std::fprintf(stderr, "[exporter] write %s failed\n", o.textfile.c_str());
+            std::this_thread::sleep_for(std::chrono::milliseconds(o.interval_ms));
+        }
+        return 0;
+    }
+
+    const socket_t ls = listen_loopback(o.port);
+    if (ls == NO_SOCKET) {
+        std::fprintf(stderr, "[exporter] cannot listen on 127.0.0.1:%u\n", o.port);
+        return 1;
+    }
+    std::printf("[exporter] %s on http://127.0.0.1:%u/metrics\n", o.name.c_str(), o.port);
+    while (g_run.load()) {
+        if (!wait_readable(ls, 250)) continue;
+        const socket_t c = ::accept(ls, nullptr, nullptr);
+        if (c == NO_SOCKET) continue;
+        serve_one(c, ex);
+        close_socket(c);
+    }
+    close_socket(ls);
+#if defined(_WIN32)
+    ::WSACleanup();
+#endif
+    return 0;
+}
@@ -0,0 +1,96 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include "shmx_columnar.h"
+#include "shmx_query.h"
+using namespace shmx;
+
+namespace {
+    struct Options {
+        std::string path;
+        QuerySpec spec{};
+        std::uint32_t threads{0};
+        std::size_t show_frames{0};
+    };
+
+    bool parse_op(const std::string& s, simd::CmpOp& op) {
+        if (s == ">" || s == "gt")
+            op = simd::CmpOp::Gt;
+        else if (s == ">=" || s == "ge")
+            op = simd::CmpOp::Ge;
+        else if (s == "<" || s == "lt")
+            op = simd::CmpOp::Lt;
+        else if (s == "<=" || s == "le")
+            op = simd::CmpOp::Le;
+        else if (s == "==" || s == "eq")
+            op = simd::CmpOp::Eq;
+        else if (s == "!=" || s == "ne")
+            op = simd::CmpOp::Ne;
+        else
+            return false;
+        return true;
+    }
+
+    bool parse(int argc, char** argv, Options& o) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string a = argv[i];
+            if (a.rfind("--", 0) != 0) {
+                o.path = a;
+                continue;
+            }
+            if (a == "--where") {
+                if (i + 3 >= argc) return false;
+                QueryPredicate p{argv[i + 1], simd::CmpOp::Gt, std::strtod(argv[i + 3], nullptr)};
+                if (!parse_op(argv[i + 2], p.op)) return false;
+                o.spec.where = p;
+                i += 3;
+                continue;
+            }
+            if (i + 1 >= argc) return false;
+            const char* v = argv[++i];
+            if (a == "--column")
+                o.spec.column = v;
+            else if (a == "--threads")
+                o.threads = static_cast<std::uint32_t>(std::strtoul(v, nullptr, 10));
+            else if (a == "--frames")
+                o.show_frames = std::strtoull(v, nullptr, 10);
+            else
+                return false;
+        }
+        o.spec.collect_frames = o.show_frames != 0u;
+        return !o.path.empty() && (!o.spec.column.empty() || o.spec.where);
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    Options o;
+    if (!parse(argc, argv, o)) {
+        std::fprintf(stderr, "usage: %s <file.shmxc> [--column NAME] [--where NAME (>|>=|<|<=|==|!=) VALUE] [--threads N] [--frames N]\n", argv[0]);
+        return 2;
+    }
+    ColumnarFile cf;
+    if (!cf.open(o.path)) {
+        std::fprintf(stderr, "[query] cannot open %s\n", o.path.c_str());
+        return 1;
+    }
+    ThreadPool pool(o.threads);
+    QueryResult r;
+    const auto t0 = std::chrono::steady_clock::now();
+    if (!run_query(cf, o.spec, pool, r)) {
+        std::fprintf(stderr, "[query] unknown or non-numeric column\n");
+        return 1;
+    }
+    const auto ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+    std::printf("rows     matched %llu of %llu (scanned %llu)\n", static_cast<unsigned long long>(r.rows_matched), static_cast<unsigned long long>(cf.rows()), static_cast<unsigned long long>(r.rows_scanned));
+    std::printf("groups   %u total, %u skipped by zone map, %u answered from zone map\n", r.groups, r.groups_skipped, r.groups_from_stats);
+    if (r.agg.count)
+        std::printf("values   count %llu  min %.9g  max %.9g  sum %.9g  mean %.9g\n", static_cast<unsigned long long>(r.agg.count), r.agg.min, r.agg.max, r.agg.sum, r.agg.sum / static_cast<double>(r.agg.count));
+    else
+        std::printf("values   count 0\n");
+    if (r.agg.nan_count) std::printf("nan      %llu\n", static_cast<unsigned long long>(r.agg.nan_count));
+    for (std::size_t i = 0; i < r.frames.size() && i < o.show_frames; ++i) std::printf("frame    %llu\n", static_cast<unsigned long long>(r.frames[i]));
+    std::printf("time     %.2f ms on %u threads\n", ms, pool.size());
+    return 0;
+}
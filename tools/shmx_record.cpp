@@ -0,0 +1,103 @@
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include "shmx_client.h"
+#include "shmx_record.h"
+using namespace shmx;
+
+static std::atomic<bool> g_run{true};
+#if defined(_WIN32)
+BOOL WINAPI console_handler(DWORD) {
+    g_run = false;
+    return TRUE;
+}
+#else
+void sigint_handler(int) {
+    g_run = false;
+}
+#endif
+
+namespace {
+    struct Options {
+        std::string name{"shmx_demo"}, out;
+        std::uint64_t max_frames{0};
+        std::uint32_t seconds{0};
+    };
+
+    bool parse(int argc, char** argv, Options& o) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string a = argv[i];
+            if (i + 1 >= argc) return false;
+            const char* v = argv[++i];
+            if (a == "--name")
+                o.name = v;
+            else if (a == "--out")
+                o.out = v;
+            else if (a == "--frames")
+                o.max_frames = std::strtoull(v, nullptr, 10);
+            else if (a == "--seconds")
+                o.seconds = static_cast<std::uint32_t>(std::strtoul(v, nullptr, 10));
+            else
+                return false;
+        }
+        return !o.out.empty();
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    Options o;
+    if (!parse(argc, argv, o)) {
+        std::fprintf(stderr, "usage: %s [--name shm] --out FILE [--frames N] [--seconds S]\n", argv[0]);
+        return 2;
+    }
+#if defined(_WIN32)
+    SetConsoleCtrlHandler(console_handler, TRUE);
+#else
+    std::signal(SIGINT, sigint_handler);
+    std::signal(SIGTERM, sigint_handler);
+#endif
+
+    Client cli;
+    if (!cli.open(o.name)) {
+        std::fprintf(stderr, "[record] cannot open %s\n", o.name.c_str());
+        return 1;
+    }
+    RecordWriter rec;
+    if (!rec.open(o.out, cli.header()->session_id)) {
+        std::fprintf(stderr, "[record] cannot write %s\n", o.out.c_str());
+        return 1;
+    }
+    std::printf("[record] %s -> %s\n", o.name.c_str(), o.out.c_str());
+
+    const auto t_end = std::chrono::steady_clock::now() + std::chrono::seconds(o.seconds);
+    std::vector<std::uint8_t> raw, payload;
+    std::uint32_t static_gen = UINT32_MAX, gen = 0;
+    std::uint64_t last = 0, missed = 0;
+    bool ok = true;
+    while (ok && g_run.load() && (o.max_frames == 0 || rec.frames() < o.max_frames) && (o.seconds == 0 || std::chrono::steady_clock::now() < t_end)) {
+        if (!cli.wait_frame(last, 100'000'000ull)) continue;
+        if (cli.copy_static(raw, gen) && gen != static_gen) {
+            ok         = rec.write_static(raw.data(), static_cast<std::uint32_t>(raw.size()));
+            static_gen = gen;
+        }
+        FrameView fv;
+        if (!cli.latest(fv)) continue;
+        const auto fid = fv.fh->frame_id.load(std::memory_order_acquire);
+        if (fid <= last) continue;
+        const double sim_time = fv.fh->sim_time;
+        const auto tlv_count  = fv.fh->tlv_count;
+        payload.assign(fv.payload, fv.payload + fv.bytes);
+        if (fv.fh->frame_id.load(std::memory_order_acquire) != fid) continue;
+        if (last != 0 && fid > last + 1u) missed += fid - last - 1u;
+        ok   = ok && rec.write_frame(fid, sim_time, tlv_count, payload.data(), static_cast<std::uint32_t>(payload.size()));
+        last = fid;
+    }
+    ok = rec.close() && ok;
+    std::printf("[record] %llu frames, %llu missed%s\n", static_cast<unsigned long long>(rec.frames()), static_cast<unsigned long long>(missed), ok ? "" : " (write error)");
+    return ok ? 0 : 1;
+}
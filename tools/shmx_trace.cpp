@@ -0,0 +1,143 @@
+#include "shmx_trace.h"
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace shmx;
+
+namespace {
+    struct TraceFile {
+        std::string path, role;
+        std::uint32_t pid{};
+        std::unordered_map<std::uint32_t, std::string> names;
+        std::vector<TraceRecord> records;
+    };
+
+    bool read_exact(std::FILE* f, void* dst, std::size_t n) {
+        return n == 0 || std::fread(dst, n, 1, f) == 1;
+    }
+
+    bool load(const std::string& path, TraceFile& out) {
+        std::FILE* f = std::fopen(path.c_str(), "rb");
+        if (!f) return false;
+        TraceFileHeader h{};
+        bool ok = read_exact(f, &h, sizeof(h)) && h.magic == TRACE_MAGIC && h.version == TRACE_VERSION;
+        if (ok) {
+            out.path = path;
+            out.pid  = h.pid;
+            out.role.resize(h.role_len);
+            ok = read_exact(f, out.role.data(), h.role_len);
+        }
+        for (std::uint32_t i = 0; ok && i < h.name_count; ++i) {
+            TraceNameEntry e{};
+            ok = read_exact(f, &e, sizeof(e));
+            if (!ok) break;
+            std::string nm(e.name_len, '\0');
+            ok                = read_exact(f, nm.data(), e.name_len);
+            out.names[e.stage] = std::move(nm);
+        }
+        if (ok) {
+            out.records.resize(static_cast<std::size_t>(h.record_count));
+            ok = read_exact(f, out.records.data(), out.records.size() * sizeof(TraceRecord));
+        }
+        std::fclose(f);
+        return ok;
+    }
+
+    std::string json_escape(const std::string& s) {
+        std::string r;
+        r.reserve(s.size());
+        for (const char c : s) {
+            if (c == '"' || c == '\\') {
+                r.push_back('\\');
+                r.push_back(c);
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                char buf[8];
+                std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned>(c));
+                r += buf;
+            } else {
+                r.push_back(c);
+            }
+        }
+        return r;
+    }
+
+    std::string stage_label(const TraceFile& tf, std::uint32_t stage) {
+        if (const auto it = tf.names.find(stage); it != tf.names.end()) return it->second;
+        if (const char* s = stage_name(stage)) return s;
+        return "stage_" + std::to_string(stage);
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::fprintf(stderr, "usage: %s <out.json> <trace> [trace...]\n", argv[0]);
+        return 2;
+    }
+    std::vector<TraceFile> files;
+    for (int i = 2; i < argc; ++i) {
+        TraceFile tf;
+        if (!load(argv[i], tf)) {
+            std::fprintf(stderr, "[trace] cannot read %s\n", argv[i]);
+            return 1;
+        }
+        files.push_back(std::move(tf));
+    }
+
+    std::uint64_t t0 = UINT64_MAX;
+    for (auto& tf : files) {
+        std::unordered_map<std::uint32_t, std::uint64_t> seq_to_frame;
+        for (const auto& r : tf.records) {
+            if (r.stage == STAGE_PUBLISH && r.seq != 0u) seq_to_frame[r.seq] = r.frame_id;
+        }
+        for (auto& r : tf.records) {
+            if (r.frame_id == 0u && r.seq != 0u) {
+                if (const auto it = seq_to_frame.find(r.seq); it != seq_to_frame.end()) r.frame_id = it->second;
+            }
+            t0 = std::min(t0, r.start_ns);
+        }
+    }
+    if (t0 == UINT64_MAX) t0 = 0;
+
+    std::FILE* out = std::fopen(argv[1], "wb");
+    if (!out) {
+        std::fprintf(stderr, "[trace] cannot write %s\n", argv[1]);
+        return 1;
+    }
+    std::fprintf(out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    bool first = true;
+    auto sep   = [&]() {
+        if (!first) std::fprintf(out, ",\n");
+        first = false;
+    };
+    std::size_t events = 0;
+    for (const auto& tf : files) {
+        const std::string role = tf.role.empty() ? tf.path : tf.role;
+        sep();
+        std::fprintf(out, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":0,\"args\":{\"name\":\"%s\"}}", tf.pid, json_escape(role).c_str());
+        std::unordered_map<std::uint64_t, bool> flow_done;
+        for (const auto& r : tf.records) {
+            const double ts  = static_cast<double>(r.start_ns - t0) / 1000.0;
+            const double dur = static_cast<double>(r.dur_ns) / 1000.0;
+            const auto label = json_escape(stage_label(tf, r.stage));
+            sep();
+            std::fprintf(out, "{\"name\":\"%s\",\"cat\":\"shmx\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%u,\"tid\":%u,\"args\":{\"frame_id\":%llu,\"seq\":%u,\"arg\":%u}}", label.c_str(), ts, dur, tf.pid, r.tid, static_cast<unsigned long long>(r.frame_id), r.seq, r.arg);
+            ++events;
+            if (r.frame_id == 0u) continue;
+            if (r.stage == STAGE_PUBLISH) {
+                sep();
+                std::fprintf(out, "{\"name\":\"frame\",\"cat\":\"shmx\",\"ph\":\"s\",\"id\":%llu,\"ts\":%.3f,\"pid\":%u,\"tid\":%u}", static_cast<unsigned long long>(r.frame_id), ts + dur, tf.pid, r.tid);
+            } else if (r.stage != STAGE_BEGIN_FRAME && r.stage != STAGE_APPEND_STREAM && r.stage != STAGE_CHECKSUM && !flow_done[r.frame_id]) {
+                flow_done[r.frame_id] = true;
+                sep();
+                std::fprintf(out, "{\"name\":\"frame\",\"cat\":\"shmx\",\"ph\":\"f\",\"bp\":\"e\",\"id\":%llu,\"ts\":%.3f,\"pid\":%u,\"tid\":%u}", static_cast<unsigned long long>(r.frame_id), ts, tf.pid, r.tid);
+            }
+        }
+    }
+    std::fprintf(out, "\n]}\n");
+    std::fclose(out);
+    std::printf("[trace] %zu files %zu events -> %s\n", files.size(), events, argv[1]);
+    return 0;
+}